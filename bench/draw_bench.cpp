@@ -0,0 +1,344 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "Renderer.h"
+
+using namespace voi;
+
+/*cpu cost of every draw call of the engine, with the null gl backend so no driver time gets in. every case
+submits count primitives per frame between Clear and the draw, only the submission is timed. needs no gl
+library or display
+
+	voi_draw_bench [--count N] [--frames N] [--workers N] [--font file.ttf]*/
+
+// every allocation through operator new, the engine doesn't use any other allocator. all the forms are
+// replaced, arrays, sized, aligned and nothrow, so none of them gets past the count
+static std::atomic<ui64> allocations{ 0 };
+
+static void* allocate(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size > 0 ? size : 1);
+}
+
+// out of line, gcc warns about free on what operator new returned once a delete is inlined next to the new
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+static void release(void* p) { free(p); }
+
+// aligned blocks come from another allocator on windows and have to go back to it
+static void* allocateAligned(size_t size, std::align_val_t alignment) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	const size_t align = (size_t)alignment;
+	size = size > 0 ? (size + align - 1) / align * align : align;
+#ifdef _WIN32
+	return _aligned_malloc(size, align);
+#else
+	return aligned_alloc(align, size);
+#endif
+}
+
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+static void releaseAligned(void* p) {
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+void* operator new(size_t size) {
+	void* p = allocate(size);
+	if (p == NULL) throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	void* p = allocateAligned(size, alignment);
+	if (p == NULL) throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+struct Options {
+	ui32 count = 10000;
+	ui32 frames = 100;
+	ui32 warmup = 10;
+	i32 workers = 0;
+	std::string font;
+};
+
+/*fixed seed so every run submits the same*/
+struct Random {
+	ui32 state = 12345;
+
+	float next() {
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) * (1.f / 16777216.f);
+	}
+};
+
+class DrawBench : public VoiOGLEngine {
+	struct Case {
+		const char* name;
+		std::function<void(ui32 count)> submit;
+
+		double seconds = 0.0;
+		ui64 allocations = 0;
+		ui64 glCalls = 0;
+		ui64 frames = 0;
+	};
+
+	const Options options;
+	std::vector<Case> cases;
+	ui64 tick = 0;
+	NullGLStats lastGL;
+	Random random;
+
+	std::vector<Vec2f> points;
+	std::vector<Rect2D> rects;
+	std::vector<FillVertex2D> hexagon;
+	std::vector<ui32> hexagonElements;
+	std::vector<std::vector<Vec2f>> polygons;
+	std::vector<Vec2f> polyline;
+	i32 font = -1;
+
+	GAO* gao = nullptr;
+	RenderBatch* batch = nullptr;
+
+public:
+	DrawBench(const Options& _options) : options(_options) {}
+	~DrawBench() {
+		delete batch;
+		delete gao;
+	}
+
+	ui32 span() const { return options.warmup + options.frames + 1; }
+
+	void Begin() override {
+		GetCamera().SetPixelSpace();
+
+		for (ui32 i = 0; i < options.count; i++) {
+			points.push_back({ 20.f + random.next() * 1240.f, 20.f + random.next() * 680.f });
+			rects.push_back({ points[i].x - 8.f, points[i].y - 8.f, 4.f + random.next() * 12.f, 4.f + random.next() * 12.f });
+		}
+
+		for (ui32 i = 0; i < 6; i++) {
+			const float a = 2.f * F_PI * i / 6;
+			hexagon.emplace_back(Vec2f{ cosf(a) * 8.f, sinf(a) * 8.f }, Pixel{ 1.f, 1.f, 1.f, 1.f });
+		}
+		hexagonElements = { 0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5 };
+
+		// a few concave outlines, repeated like shapes of a level so the triangulation cache hits
+		for (ui32 p = 0; p < 64; p++) {
+			std::vector<Vec2f> outline;
+			for (ui32 i = 0; i < 12; i++) {
+				const float a = 2.f * F_PI * i / 12;
+				const float r = (i & 1) ? 4.f + p * 0.05f : 10.f;
+				outline.push_back({ cosf(a) * r, sinf(a) * r });
+			}
+			polygons.push_back(outline);
+		}
+
+		for (ui32 i = 0; i < 16; i++) polyline.push_back({ i * 4.f, (i & 1) * 6.f });
+
+		if (!options.font.empty()) font = LoadFont(options.font, 16.f);
+
+		// a batch of its own to time RenderBatch alone, nothing draws it
+		gao = new GAO(1);
+		batch = new RenderBatch(gao, 0, glCreateProgram());
+		batch->defineVertBufferData({ 3,4 });
+
+		const ui32 quad[6] = { 0, 1, 2, 2, 3, 0 };
+
+		cases = {
+			{ "FillRect", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h); } },
+			{ "FillTriangle", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillTriangle(points[i], points[i] + Vec2f{ 8.f, 0.f }, points[i] + Vec2f{ 4.f, 8.f }); } },
+			{ "FillQuad", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillQuad(points[i], points[i] + Vec2f{ 8.f, 1.f }, points[i] + Vec2f{ 9.f, 9.f }, points[i] + Vec2f{ 0.f, 8.f }); } },
+			{ "FillRects", [this](ui32 /*n*/) { FillRects(rects); } },
+			{ "TextureRect", [this](ui32 n) { for (ui32 i = 0; i < n; i++) TextureRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h); } },
+			{ "TextureRects", [this](ui32 /*n*/) { TextureRects(rects); } },
+			{ "FillShape", [this](ui32 n) {
+				for (ui32 i = 0; i < n; i++) {
+					for (size_t v = 0; v < hexagon.size(); v++) hexagon[v].pos.pos = points[i] + Vec2f{ cosf(v * F_PI / 3.f) * 8.f, sinf(v * F_PI / 3.f) * 8.f };
+					FillShape(hexagon, hexagonElements);
+				}
+			} },
+			{ "FillPolygon", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillPolygon(polygons[i % polygons.size()]); } },
+			{ "FillCircle", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillCircle(points[i], 6.f); } },
+			{ "FillRoundedRect", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillRoundedRect(rects[i].x, rects[i].y, 16.f, 12.f, 3.f); } },
+			{ "FillCircleSdf", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillCircleSdf(points[i], 6.f); } },
+			{ "FillRoundedRectSdf", [this](ui32 n) { for (ui32 i = 0; i < n; i++) FillRoundedRectSdf(rects[i].x, rects[i].y, 16.f, 12.f, 3.f); } },
+			{ "DrawLine", [this](ui32 n) { for (ui32 i = 0; i < n; i++) DrawLine(points[i], points[(i + 1) % n], 2.f); } },
+			{ "DrawPolyline 16", [this](ui32 n) {
+				std::vector<Vec2f> moved(polyline.size());
+				for (ui32 i = 0; i < n; i++) {
+					for (size_t p = 0; p < polyline.size(); p++) moved[p] = points[i] + polyline[p];
+					DrawPolyline(moved, 2.f);
+				}
+			} },
+			{ "FillTransformedRect", [this](ui32 n) {
+				ClearTransformed();
+				const ui32 t = AddTransform();
+				for (ui32 i = 0; i < n; i++) FillTransformedRect(t, rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+			} },
+			{ "RenderBatch::addVertices", [this](ui32 n) {
+				batch->clearVertices();
+				for (ui32 i = 0; i < n; i++) {
+					const Rect2D& r = rects[i];
+					batch->addVertices({
+						      r.x,       r.y, 0.f, 1.f, 1.f, 1.f, 1.f,
+						r.x + r.w,       r.y, 0.f, 1.f, 1.f, 1.f, 1.f,
+						r.x + r.w, r.y + r.h, 0.f, 1.f, 1.f, 1.f, 1.f,
+						      r.x, r.y + r.h, 0.f, 1.f, 1.f, 1.f, 1.f
+					}, { 0, 1, 2, 2, 3, 0 });
+				}
+			} },
+			{ "RenderBatch::addVertices in place", [this, quad](ui32 n) {
+				batch->clearVertices();
+				for (ui32 i = 0; i < n; i++) {
+					const Rect2D& r = rects[i];
+					const float vertices[28] = {
+						      r.x,       r.y, 0.f, 1.f, 1.f, 1.f, 1.f,
+						r.x + r.w,       r.y, 0.f, 1.f, 1.f, 1.f, 1.f,
+						r.x + r.w, r.y + r.h, 0.f, 1.f, 1.f, 1.f, 1.f,
+						      r.x, r.y + r.h, 0.f, 1.f, 1.f, 1.f, 1.f
+					};
+					memcpy(batch->addVertices(4, quad, 6), vertices, sizeof(vertices));
+				}
+			} },
+		};
+
+		if (font >= 0) {
+			cases.push_back({ "DrawText 16 chars", [this](ui32 n) { for (ui32 i = 0; i < n; i++) DrawText((ui32)font, "sixteen letters.", points[i]); } });
+		}
+
+		std::cout << std::setw(36) << std::left << "api" << std::right << std::setw(10) << "prims"
+			<< std::setw(14) << "Mprims/s" << std::setw(10) << "ns/prim" << std::setw(14) << "allocs/frame"
+			<< std::setw(16) << "gl calls/frame" << "\n";
+	}
+
+	void Update(float /*deltaTime*/) override {
+		const ui32 index = (ui32)(tick / span());
+		const ui32 local = (ui32)(tick % span());
+		tick++;
+
+		// gl calls made by the draw of the frame before
+		const NullGLStats gl = NullGL::Stats();
+		const ui64 glCalls = gl.calls - lastGL.calls;
+
+		if (index >= cases.size()) {
+			Close();
+			return;
+		}
+		Case& c = cases[index];
+		if (local > options.warmup + 1) c.glCalls += glCalls;
+
+		Clear();
+		const ui64 allocationsBefore = allocations.load(std::memory_order_relaxed);
+		const auto start = std::chrono::steady_clock::now();
+
+		c.submit(options.count);
+
+		const auto end = std::chrono::steady_clock::now();
+		const ui64 allocationsAfter = allocations.load(std::memory_order_relaxed);
+
+		if (local > options.warmup) {
+			c.seconds += std::chrono::duration<double>(end - start).count();
+			c.allocations += allocationsAfter - allocationsBefore;
+			c.frames++;
+		}
+
+		if (local + 1 == span()) report(c);
+		lastGL = NullGL::Stats();
+	}
+
+	void Finish() override {}
+
+private:
+	void report(const Case& c) {
+		const double primitives = (double)options.count * c.frames;
+		// gl calls are read a frame late, so the first measured frame isn't in them
+		const double glFrames = c.frames > 1 ? (double)(c.frames - 1) : 1.0;
+
+		std::cout << std::setw(36) << std::left << c.name << std::right << std::setw(10) << options.count
+			<< std::setw(14) << std::fixed << std::setprecision(2) << primitives / c.seconds * 1e-6
+			<< std::setw(10) << std::setprecision(1) << c.seconds / primitives * 1e9
+			<< std::setw(14) << std::setprecision(1) << (double)c.allocations / c.frames
+			<< std::setw(16) << std::setprecision(1) << c.glCalls / glFrames << "\n";
+	}
+};
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const std::string arg = argv[i];
+		const char* value = argv[i + 1];
+
+		if (arg == "--count") options.count = (ui32)atoi(value);
+		else if (arg == "--frames") options.frames = (ui32)atoi(value);
+		else if (arg == "--workers") options.workers = atoi(value);
+		else if (arg == "--font") options.font = value;
+		else {
+			std::cout << "unknown option " << arg << std::endl;
+			return false;
+		}
+	}
+	if (argc % 2 == 0) {
+		std::cout << "missing value for " << argv[argc - 1] << std::endl;
+		return false;
+	}
+
+	options.count = options.count > 0 ? options.count : 1;
+	options.frames = options.frames > 0 ? options.frames : 1;
+	return true;
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) return 1;
+
+	DrawBench bench(options);
+
+	EngineConfig config;
+	config.nullGL = true;
+	config.jobWorkers = options.workers;
+
+	if (!bench.Construct("voi_draw_bench", 1280, 720, config)) return 1;
+	bench.Start();
+
+	return 0;
+}
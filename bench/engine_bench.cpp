@@ -0,0 +1,643 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "Renderer.h"
+
+using namespace voi;
+
+/*standard scenes drawn headless for a fixed number of frames each, reported as json so runs can be compared
+between versions and machines. run it from the build directory, the shaders are read from there
+
+	voi_bench [--frames N] [--warmup N] [--size WxH] [--latency 0-2] [--scene name] [--out file.json]
+	          [--capture directory] [--backend gl33|gl45|software] [--compare gl33|gl45|software] [--tolerance N]
+
+with --capture the last frame of every scene is written as <scene>.png to check what was drawn. --compare
+runs every scene again with another backend and counts the pixels of the last frames differing by more than
+--tolerance in any channel, the run fails when more than a thousandth of a scene does. the software backend
+draws no sdf shapes or text, the scenes using them are compared but can't fail*/
+
+struct Options {
+	ui32 width = 1280, height = 720;
+	ui32 frames = 300;
+	ui32 warmup = 30;
+	ui32 latency = 0;
+	std::string scene;
+	std::string out;
+	std::string capture;
+	BackendType backend = BackendType::GL33;
+	BackendType compare = BackendType::GL33;
+	bool comparing = false;
+	// texture filtering is only as precise as the gl implementation makes it
+	ui32 tolerance = 4;
+};
+
+// pixels over the tolerance a scene may have before the comparison fails, edges may be rasterized differently
+static const double MAX_DIFFERING = 0.001;
+
+
+/*per frame sums of the measured frames of one scene*/
+struct SceneResult {
+	const char* name;
+	bool software;
+	std::vector<float> cpuTimes;
+	double gpuTime = 0.0;
+	DrawStats draw;
+
+	// last frame, RGBA8 rows from the top
+	std::vector<ui8> frame;
+	ui32 frameWidth = 0, frameHeight = 0;
+};
+
+/*every scene drawn with one backend*/
+struct Run {
+	std::string renderer;
+	std::string backend;
+	std::vector<SceneResult> results;
+};
+
+/*fixed seed so every run draws the same*/
+struct Random {
+	ui32 state = 12345;
+
+	float next() {
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) * (1.f / 16777216.f);
+	}
+};
+
+class Bench : public VoiOGLEngine {
+	struct Scene {
+		const char* name;
+		void (Bench::*setup)();
+		void (Bench::*draw)(ui32 frame);
+		// draws nothing the software backend leaves out
+		bool software;
+	};
+
+	const Options options;
+	// png names end with it, so the runs of a comparison don't write over each other
+	const std::string suffix;
+	std::vector<Scene> scenes;
+	std::vector<SceneResult> results;
+	std::string renderer;
+	ui64 tick = 0;
+	Random random;
+
+	// solid rects, four colors
+	std::vector<Rect2D> solidRects[4];
+
+	// sprites sorted by the texture they use
+	std::vector<ui32> spriteTextures;
+	std::vector<std::vector<Rect2D>> sprites;
+
+	std::vector<std::vector<FillVertex2D>> shapes;
+	std::vector<ui32> shapeElements;
+
+	std::vector<ui32> streamTextures;
+	std::vector<ui8> streamPixels;
+	std::vector<Rect2D> streamRects;
+
+	std::vector<Rect2D> layerRects;
+	std::vector<Vec2f> layerCircles;
+
+	std::vector<ui32> translucentTextures;
+	std::vector<std::vector<Rect2D>> translucentSprites;
+	std::vector<Rect2D> opaqueRects;
+
+	static constexpr ui32 STREAM_SIZE = 512;
+
+public:
+	Bench(const Options& _options, const std::string& _suffix = "") : options(_options), suffix(_suffix) {
+		const Scene all[] = {
+			{ "solid_rects", &Bench::setupSolidRects, &Bench::drawSolidRects, true },
+			{ "textured_sprites", &Bench::setupSprites, &Bench::drawSprites, true },
+			{ "dense_shapes", &Bench::setupShapes, &Bench::drawShapes, true },
+			{ "texture_streaming", &Bench::setupStreaming, &Bench::drawStreaming, true },
+			{ "translucent_layers", &Bench::setupLayers, &Bench::drawLayers, false },
+			{ "translucent_sprites", &Bench::setupTranslucent, &Bench::drawTranslucent, true },
+		};
+		for (const Scene& scene : all) {
+			if (options.scene.empty() || options.scene == scene.name) scenes.push_back(scene);
+		}
+	}
+
+	ui32 sceneCount() const { return (ui32)scenes.size(); }
+
+	/*frames each scene takes, warmup included plus the one its last measured frame is read in*/
+	ui32 span() const { return options.warmup + options.frames + 1; }
+
+	/*once Start returns*/
+	Run takeRun() { return { renderer, GetBackendName(), std::move(results) }; }
+
+	void Begin() override {
+		const char* name = (const char*)glGetString(GL_RENDERER);
+		renderer = name != NULL ? name : "";
+
+		GetCamera().SetPixelSpace();
+		SetCulling(false);
+	}
+
+	void Update(float deltaTime) override {
+		const ui32 scene = (ui32)(tick / span());
+		const ui32 local = (ui32)(tick % span());
+		tick++;
+
+		takeFrame();
+		if (scene >= scenes.size()) return;
+
+		if (local == 0) {
+			results.push_back({ scenes[scene].name, scenes[scene].software, {}, 0.0, {}, {}, 0, 0 });
+			(this->*scenes[scene].setup)();
+		}
+		// deltaTime and the stats belong to frames before this one, still of the same scene past the warmup
+		else if (local > options.warmup) {
+			SceneResult& result = results.back();
+			const FrameStats stats = GetFrameStats();
+
+			result.cpuTimes.push_back(deltaTime);
+			result.gpuTime += stats.gpuTime;
+			result.draw.drawCalls += stats.draw.drawCalls;
+			result.draw.vertices += stats.draw.vertices;
+			result.draw.indices += stats.draw.indices;
+			result.draw.vertexBytes += stats.draw.vertexBytes;
+			result.draw.elementBytes += stats.draw.elementBytes;
+			result.draw.textureBytes += stats.draw.textureBytes;
+			result.draw.otherBytes += stats.draw.otherBytes;
+			result.draw.textureBinds += stats.draw.textureBinds;
+			result.draw.programSwitches += stats.draw.programSwitches;
+		}
+
+		if (local + 1 == span()) {
+			const bool png = !options.capture.empty();
+			CaptureNextFrame(png ? options.capture + "/" + scenes[scene].name + suffix + ".png" : "");
+		}
+
+		Clear();
+		(this->*scenes[scene].draw)(local);
+	}
+
+	// the capture of the last scene is read as the render thread stops
+	void Finish() override { takeFrame(); }
+
+private:
+	/*a capture belongs to the first scene without one, with a render thread it comes frames later*/
+	void takeFrame() {
+		std::vector<ui8> rgba;
+		ui32 width, height;
+		if (!TakeCapturedFrame(rgba, width, height)) return;
+
+		for (SceneResult& result : results) {
+			if (!result.frame.empty()) continue;
+			result.frame.swap(rgba);
+			result.frameWidth = width;
+			result.frameHeight = height;
+			return;
+		}
+	}
+
+	Rect2D randomRect(float minSize, float maxSize) {
+		const float w = minSize + random.next() * (maxSize - minSize);
+		const float h = minSize + random.next() * (maxSize - minSize);
+		return { random.next() * (options.width - w), random.next() * (options.height - h), w, h };
+	}
+
+	//---100k solid rects---//
+
+	void setupSolidRects() {
+		for (ui32 i = 0; i < 100000; i++) solidRects[i % 4].push_back(randomRect(2.f, 12.f));
+	}
+	void drawSolidRects(ui32 /*frame*/) {
+		const Pixel colors[4] = { { 0.9f, 0.3f, 0.2f, 1.f }, { 0.2f, 0.8f, 0.3f, 1.f }, { 0.2f, 0.4f, 0.9f, 1.f }, { 0.9f, 0.8f, 0.2f, 1.f } };
+		for (ui32 c = 0; c < 4; c++) {
+			drawColor = colors[c];
+			FillRects(solidRects[c]);
+		}
+	}
+
+	//---50k sprites over every texture batch---//
+
+	void setupSprites() {
+		const ui32 size = 64;
+		std::vector<ui8> pixels(size * size * 4);
+
+		for (ui32 t = 0; t < 32; t++) {
+			// checkerboard of a color of its own, so every texture holds different data
+			for (ui32 y = 0; y < size; y++) {
+				for (ui32 x = 0; x < size; x++) {
+					ui8* p = &pixels[(y * size + x) * 4];
+					const bool dark = ((x / 8) ^ (y / 8)) & 1;
+					p[0] = (ui8)(dark ? t * 4 : 255 - t * 4);
+					p[1] = (ui8)(dark ? 64 : 128 + t * 3);
+					p[2] = (ui8)(dark ? 255 - t * 6 : t * 6);
+					p[3] = 255;
+				}
+			}
+
+			const ui32 id = AddTexture(size, size, pixels.data(), true);
+			if (id == (ui32)-1) break;
+			spriteTextures.push_back(id);
+		}
+
+		sprites.resize(spriteTextures.size());
+		for (ui32 i = 0; i < 50000 && !sprites.empty(); i++) sprites[i % sprites.size()].push_back(randomRect(8.f, 24.f));
+	}
+	void drawSprites(ui32 /*frame*/) {
+		drawColor = { 0.f, 0.f, 0.f, 0.f };
+		for (size_t t = 0; t < sprites.size(); t++) {
+			ChooseCurrentTextures(spriteTextures[t]);
+			TextureRects(sprites[t]);
+		}
+	}
+
+	//---dense FillShape polygons---//
+
+	void setupShapes() {
+		const ui32 sides = 48;
+
+		for (ui32 s = 0; s < 4000; s++) {
+			const float radius = 4.f + random.next() * 20.f;
+			const float cx = radius + random.next() * (options.width - 2.f * radius);
+			const float cy = radius + random.next() * (options.height - 2.f * radius);
+			const Pixel color = { random.next(), random.next(), random.next(), 1.f };
+
+			std::vector<FillVertex2D> shape;
+			shape.emplace_back(Vec2f{ cx, cy }, color);
+			for (ui32 i = 0; i < sides; i++) {
+				const float a = 2.f * F_PI * i / sides;
+				// wavy outline, so the vertices are not all on a circle
+				const float r = radius * (0.75f + 0.25f * sinf(a * 5.f));
+				shape.emplace_back(Vec2f{ cx + cosf(a) * r, cy + sinf(a) * r }, color);
+			}
+			shapes.push_back(shape);
+		}
+
+		for (ui32 i = 0; i < sides; i++) {
+			shapeElements.push_back(0);
+			shapeElements.push_back(1 + i);
+			shapeElements.push_back(1 + (i + 1) % sides);
+		}
+	}
+	void drawShapes(ui32 /*frame*/) {
+		for (const auto& shape : shapes) FillShape(shape, shapeElements);
+	}
+
+	//---a texture rewritten every frame---//
+
+	void setupStreaming() {
+		streamPixels.resize(STREAM_SIZE * STREAM_SIZE * 4);
+
+		// the sprite scene may have taken every texture batch, the streamed ones reuse the first four
+		for (ui32 t = 0; t < 4; t++) {
+			ui32 id = AddTexture(STREAM_SIZE, STREAM_SIZE, streamPixels.data());
+			if (id == (ui32)-1) id = ChangeTexture(t, STREAM_SIZE, STREAM_SIZE, streamPixels.data());
+			streamTextures.push_back(id);
+		}
+
+		const float w = options.width * 0.5f, h = options.height * 0.5f;
+		streamRects = { { 0.f, 0.f, w, h }, { w, 0.f, w, h }, { 0.f, h, w, h }, { w, h, w, h } };
+	}
+	void drawStreaming(ui32 frame) {
+		drawColor = { 0.f, 0.f, 0.f, 0.f };
+
+		for (size_t t = 0; t < streamTextures.size(); t++) {
+			// moving gradient, different for every texture and frame
+			const ui32 shift = frame * 3 + (ui32)t * 64;
+			for (ui32 y = 0; y < STREAM_SIZE; y++) {
+				ui8* row = &streamPixels[y * STREAM_SIZE * 4];
+				for (ui32 x = 0; x < STREAM_SIZE; x++) {
+					row[x * 4 + 0] = (ui8)(x + shift);
+					row[x * 4 + 1] = (ui8)(y + shift);
+					row[x * 4 + 2] = (ui8)(x ^ y);
+					row[x * 4 + 3] = 255;
+				}
+			}
+
+			// textures sample with mipmaps, so they are built again with every upload
+			ChangeTexture(streamTextures[t], STREAM_SIZE, STREAM_SIZE, streamPixels.data());
+			ChooseCurrentTextures(streamTextures[t]);
+			TextureRect(streamRects[t].x, streamRects[t].y, streamRects[t].w, streamRects[t].h);
+		}
+	}
+
+	//---opaque rects under translucent circles, in alternating layers---//
+
+	void setupLayers() {
+		for (ui32 i = 0; i < 2000; i++) layerRects.push_back(randomRect(10.f, 60.f));
+		for (ui32 i = 0; i < 2000; i++) layerCircles.push_back({ random.next() * options.width, random.next() * options.height });
+	}
+	void drawLayers(ui32 /*frame*/) {
+		const ui32 layers = 8;
+
+		for (ui32 l = 0; l < layers; l++) {
+			// layers further down the list are in front
+			const float z = 0.9f - l * 0.2f;
+			const float offset = l * 13.f;
+
+			drawColor = { 0.1f * l, 0.3f, 1.f - 0.1f * l, 1.f };
+			for (ui32 i = l; i < layerRects.size(); i += layers) {
+				const Rect2D& r = layerRects[i];
+				FillRect(r.x, r.y, r.w, r.h, z);
+			}
+
+			drawColor = { 1.f, 0.5f + 0.05f * l, 0.2f, 0.35f };
+			for (ui32 i = l; i < layerCircles.size(); i += layers) {
+				const Vec2f c = layerCircles[i] + Vec2f{ offset, offset };
+				FillCircleSdf(c, 10.f + (i % 5) * 4.f, 0.f, z - 0.1f);
+			}
+		}
+	}
+
+	//---overlapping translucent sprites over opaque rects, at interleaved depths---//
+
+	void setupTranslucent() {
+		const ui32 size = 64;
+		std::vector<ui8> pixels(size * size * 4);
+
+		for (ui32 t = 0; t < 4; t++) {
+			// checkerboard of two alphas, so blending goes over both filtered and unfiltered alpha edges
+			for (ui32 y = 0; y < size; y++) {
+				for (ui32 x = 0; x < size; x++) {
+					ui8* p = &pixels[(y * size + x) * 4];
+					const bool dark = ((x / 16) ^ (y / 16)) & 1;
+					p[0] = (ui8)(60 + t * 60);
+					p[1] = (ui8)(dark ? 40 : 220);
+					p[2] = (ui8)(255 - t * 60);
+					p[3] = (ui8)(dark ? 200 : 90);
+				}
+			}
+
+			// the other scenes may have taken every texture batch, these reuse the four after the streamed ones
+			ui32 id = AddTexture(size, size, pixels.data(), true);
+			if (id == (ui32)-1) id = ChangeTexture(4 + t, size, size, pixels.data());
+			SetTextureBlend(id, true);
+			translucentTextures.push_back(id);
+		}
+
+		translucentSprites.resize(translucentTextures.size());
+		for (ui32 i = 0; i < 1500; i++) translucentSprites[i % translucentSprites.size()].push_back(randomRect(16.f, 64.f));
+		for (ui32 i = 0; i < 1000; i++) opaqueRects.push_back(randomRect(10.f, 60.f));
+	}
+	void drawTranslucent(ui32 /*frame*/) {
+		const ui32 layers = 4;
+
+		// every batch has sprites in front of and behind the ones of the others, and of the opaque rects
+		for (ui32 l = 0; l < layers; l++) {
+			const float z = 0.8f - l * 0.4f;
+
+			drawColor = { 0.2f + 0.2f * l, 0.6f, 0.3f, 1.f };
+			for (ui32 i = l; i < opaqueRects.size(); i += layers) {
+				const Rect2D& r = opaqueRects[i];
+				FillRect(r.x, r.y, r.w, r.h, z + 0.1f);
+			}
+
+			drawColor = { 0.f, 0.f, 0.f, 0.f };
+			for (size_t t = 0; t < translucentSprites.size(); t++) {
+				ChooseCurrentTextures(translucentTextures[t]);
+				for (ui32 i = l; i < translucentSprites[t].size(); i += layers) {
+					const Rect2D& r = translucentSprites[t][i];
+					TextureRect(r.x, r.y, r.w, r.h, z);
+				}
+			}
+		}
+	}
+};
+
+//---report---//
+
+/*pixels of the last frames of a scene drawn by two backends*/
+struct Comparison {
+	ui32 maxDifference = 0;
+	ui64 differing = 0;
+	ui64 pixels = 0;
+	bool pass = false;
+};
+
+static Comparison compareFrames(const SceneResult& a, const SceneResult& b, ui32 tolerance) {
+	Comparison c;
+	if (a.frame.empty() || a.frame.size() != b.frame.size()) return c;
+
+	c.pixels = a.frame.size() / 4;
+	for (size_t p = 0; p < a.frame.size(); p += 4) {
+		ui32 most = 0;
+		for (size_t k = p; k < p + 4; k++) {
+			const ui32 d = (ui32)abs((i32)a.frame[k] - (i32)b.frame[k]);
+			most = d > most ? d : most;
+		}
+		c.maxDifference = most > c.maxDifference ? most : c.maxDifference;
+		if (most > tolerance) c.differing++;
+	}
+	c.pass = c.differing <= c.pixels * MAX_DIFFERING;
+	return c;
+}
+
+/*scenes drawing what the software backend leaves out differ from gl, they are reported but don't fail*/
+static bool counted(const Options& options, const SceneResult& result) {
+	return result.software || (options.backend != BackendType::Software && options.compare != BackendType::Software);
+}
+
+static void writeString(std::ostream& out, const std::string& text) {
+	out << '"';
+	for (char c : text) {
+		if (c == '"' || c == '\\') out << '\\';
+		if ((unsigned char)c >= 0x20) out << c;
+	}
+	out << '"';
+}
+
+static float percentile(std::vector<float> sorted, float percent) {
+	if (sorted.empty()) return 0.f;
+	std::sort(sorted.begin(), sorted.end());
+	const size_t k = (size_t)(percent * 0.01f * (sorted.size() - 1) + 0.5f);
+	return sorted[k < sorted.size() ? k : sorted.size() - 1];
+}
+
+/*other is the run of the backend compared against, NULL without one*/
+static void writeJson(std::ostream& out, const Options& options, const Run& run, const Run* other) {
+	const std::vector<SceneResult>& results = run.results;
+
+	out << "{\n";
+	out << "  \"renderer\": ";
+	writeString(out, run.renderer);
+	out << ", \"backend\": \"" << run.backend << "\"";
+	out << ",\n  \"width\": " << options.width << ", \"height\": " << options.height
+		<< ", \"frames\": " << options.frames << ", \"warmup\": " << options.warmup
+		<< ", \"render_latency\": " << options.latency << ",\n";
+	out << "  \"scenes\": [";
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const SceneResult& r = results[i];
+		const double n = r.cpuTimes.empty() ? 1.0 : (double)r.cpuTimes.size();
+
+		double mean = 0.0, most = 0.0;
+		for (float t : r.cpuTimes) {
+			mean += t;
+			most = t > most ? t : most;
+		}
+		mean /= n;
+
+		const ui64 total = r.draw.vertexBytes + r.draw.elementBytes + r.draw.textureBytes + r.draw.otherBytes;
+
+		out << (i > 0 ? ",\n" : "\n") << "    {\n";
+		out << "      \"name\": \"" << r.name << "\", \"frames\": " << r.cpuTimes.size() << ",\n";
+		out << "      \"cpu_frame_ms\": { \"mean\": " << mean * 1e3
+			<< ", \"p50\": " << percentile(r.cpuTimes, 50.f) * 1e3
+			<< ", \"p95\": " << percentile(r.cpuTimes, 95.f) * 1e3
+			<< ", \"p99\": " << percentile(r.cpuTimes, 99.f) * 1e3
+			<< ", \"max\": " << most * 1e3 << " },\n";
+		out << "      \"gpu_frame_ms\": { \"mean\": " << r.gpuTime / n * 1e3 << " },\n";
+		out << "      \"per_frame\": { \"draw_calls\": " << r.draw.drawCalls / n
+			<< ", \"vertices\": " << r.draw.vertices / n
+			<< ", \"indices\": " << r.draw.indices / n
+			<< ", \"texture_binds\": " << r.draw.textureBinds / n
+			<< ", \"program_switches\": " << r.draw.programSwitches / n << " },\n";
+		out << "      \"bytes_uploaded_per_frame\": { \"vertex\": " << r.draw.vertexBytes / n
+			<< ", \"element\": " << r.draw.elementBytes / n
+			<< ", \"texture\": " << r.draw.textureBytes / n
+			<< ", \"other\": " << r.draw.otherBytes / n
+			<< ", \"total\": " << total / n << " }";
+
+		if (other != NULL && i < other->results.size()) {
+			const Comparison c = compareFrames(r, other->results[i], options.tolerance);
+			out << ",\n      \"comparison\": { \"backend\": \"" << other->backend << "\""
+				<< ", \"tolerance\": " << options.tolerance
+				<< ", \"max_difference\": " << c.maxDifference
+				<< ", \"pixels_over_tolerance\": " << c.differing
+				<< ", \"fraction\": " << (c.pixels > 0 ? (double)c.differing / c.pixels : 1.0)
+				<< ", \"pass\": " << (c.pass ? "true" : "false")
+				<< ", \"counted\": " << (counted(options, r) ? "true" : "false") << " }";
+		}
+		out << "\n    }";
+	}
+
+	out << "\n  ]\n}\n";
+}
+
+static const char* backendName(BackendType backend) {
+	switch (backend) {
+	case BackendType::GL45: return "gl45";
+	case BackendType::Software: return "software";
+	default: return "gl33";
+	}
+}
+
+static bool parseBackend(const std::string& name, BackendType& backend) {
+	if (name == "gl33") backend = BackendType::GL33;
+	else if (name == "gl45") backend = BackendType::GL45;
+	else if (name == "software") backend = BackendType::Software;
+	else {
+		std::cout << "unknown backend " << name << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (value == NULL) {
+			std::cout << "missing value for " << arg << std::endl;
+			return false;
+		}
+
+		if (arg == "--frames") options.frames = (ui32)atoi(value);
+		else if (arg == "--warmup") options.warmup = (ui32)atoi(value);
+		else if (arg == "--latency") options.latency = (ui32)atoi(value);
+		else if (arg == "--scene") options.scene = value;
+		else if (arg == "--out") options.out = value;
+		else if (arg == "--capture") options.capture = value;
+		else if (arg == "--backend") {
+			if (!parseBackend(value, options.backend)) return false;
+		}
+		else if (arg == "--compare") {
+			if (!parseBackend(value, options.compare)) return false;
+			options.comparing = true;
+		}
+		else if (arg == "--tolerance") options.tolerance = (ui32)atoi(value);
+		else if (arg == "--size") {
+			if (sscanf(value, "%ux%u", &options.width, &options.height) != 2) {
+				std::cout << "size has to be WIDTHxHEIGHT" << std::endl;
+				return false;
+			}
+		}
+		else {
+			std::cout << "unknown option " << arg << std::endl;
+			return false;
+		}
+		i++;
+	}
+
+	options.frames = options.frames > 0 ? options.frames : 1;
+	options.latency = options.latency > 2 ? 2 : options.latency;
+	// the stats read in a frame are of one renderLatency + 1 frames older
+	options.warmup = options.warmup > options.latency + 2 ? options.warmup : options.latency + 2;
+	return true;
+}
+
+/*every scene drawn with backend, pngs of the captures named with suffix*/
+static bool run(const Options& options, BackendType backend, const std::string& suffix, Run& result) {
+	Bench bench(options, suffix);
+	if (bench.sceneCount() == 0) {
+		std::cout << "no scene named " << options.scene << std::endl;
+		return false;
+	}
+
+	EngineConfig config;
+	config.headless = true;
+	config.headlessFrames = (ui64)bench.sceneCount() * bench.span();
+	config.vsync = false;
+	config.renderLatency = options.latency;
+	config.backend = backend;
+
+	if (!bench.Construct("voi_bench", options.width, options.height, config)) return false;
+	bench.Start();
+
+	result = bench.takeRun();
+	return true;
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) return 1;
+
+	// one after the other, every engine owns its context and backend
+	Run first, second;
+	if (!run(options, options.backend, "", first)) return 1;
+	if (options.comparing && !run(options, options.compare, std::string("_") + backendName(options.compare), second)) return 1;
+
+	std::stringstream json;
+	writeJson(json, options, first, options.comparing ? &second : NULL);
+
+	bool pass = true;
+	for (size_t i = 0; options.comparing && i < first.results.size() && i < second.results.size(); i++) {
+		if (!counted(options, first.results[i])) continue;
+		pass = pass && compareFrames(first.results[i], second.results[i], options.tolerance).pass;
+	}
+
+	if (options.out.empty()) std::cout << json.str();
+	else {
+		std::ofstream file(options.out);
+		if (!file.is_open()) {
+			std::cout << "ERROR::BENCH::FILE_NOT_SUCCESFULLY_WRITTEN " << options.out << std::endl;
+			return 1;
+		}
+		file << json.str();
+	}
+
+	return pass ? 0 : 1;
+}
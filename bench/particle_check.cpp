@@ -0,0 +1,204 @@
+#include <glad/glad.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "GLBackend.h"
+#include "GpuParticleEmitter.h"
+#include "ParticleSystem.h"
+
+using namespace voi;
+
+/*steps a GpuParticleEmitter and a ParticleSystem through the same seeded spawns and checks that both end with the
+same particles, it fails when any position or remaining life is further apart than the tolerance. run it from the
+build directory, the shaders are read from there. the slots are never reused, so the size of every cpu particle
+is the slot of the gpu one it should match
+
+	voi_particle_check [--steps N] [--tolerance N]*/
+
+static const ui32 CAPACITY = 16384;
+
+static std::string readFile(const char* path) {
+	std::ifstream file(path);
+	std::stringstream stream;
+	stream << file.rdbuf();
+	return stream.str();
+}
+
+// same as particle_update.vert
+static ui32 hash(ui32 x) {
+	x ^= x >> 16; x *= 0x7feb352du;
+	x ^= x >> 15; x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+static float random(ui32& state) {
+	state = hash(state);
+	return (float)(state >> 8) / 16777216.f;
+}
+
+static float mix(float a, float b, float t) { return a * (1.f - t) + b * t; }
+
+/*the particles the update shader spawns for step*/
+static void spawn(ParticleSystem& cpu, const GpuParticleEmitter::Step& step) {
+	const GpuEmitterDesc& d = step.desc;
+
+	for (ui32 i = 0; i < step.spawnCount; i++) {
+		const ui32 slot = (step.spawnStart + i) % CAPACITY;
+		ui32 state = hash(slot ^ hash(step.seed));
+
+		const float angle = d.angle + (random(state) - 0.5f) * d.spread;
+		const float speed = mix(d.speedMin, d.speedMax, random(state));
+		const float r = d.radius * sqrtf(random(state));
+		const float around = random(state) * 6.2831853f;
+		const float life = mix(d.lifeMin, d.lifeMax, random(state));
+
+		ParticleDesc p;
+		p.position = { d.position.x + r * cosf(around), d.position.y + r * sinf(around) };
+		p.velocity = { speed * cosf(angle), speed * sinf(angle) };
+		p.life = life;
+		p.size = (float)slot;
+		cpu.emit(p);
+	}
+}
+
+static bool near(float a, float b, float tolerance) {
+	return fabsf(a - b) <= tolerance * (1.f + fabsf(b));
+}
+
+int main(int argc, char** argv) {
+	ui32 steps = 180;
+	float tolerance = 1e-3f;
+
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--steps" && hasValue) steps = (ui32)atoi(argv[++i]);
+		else if (arg == "--tolerance" && hasValue) tolerance = (float)atof(argv[++i]);
+		else {
+			std::cout << "usage: voi_particle_check [--steps N] [--tolerance N]" << std::endl;
+			return 2;
+		}
+	}
+
+	HeadlessContext context;
+	if (!context.create()) return 2;
+	if (!gladLoadGLLoader(HeadlessContext::Loader())) {
+		std::cout << "ERROR::GLAD::NOT_LOADED" << std::endl;
+		context.release();
+		return 2;
+	}
+
+	// the shaders check their programs through the current backend
+	GL33Backend backend;
+	CurrentBackend() = &backend;
+
+	// surfaceless contexts have no default framebuffer, and draws fail without a complete one even with the rasterizer off
+	ui32 framebuffer, renderbuffer;
+	glGenRenderbuffers(1, &renderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1, 1);
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+
+	ui32 varyingCount;
+	const char* const* varyings = GpuParticleEmitter::Varyings(varyingCount);
+	const ui32 updateProgram = Shader::feedbackProgramLinking(readFile("particle_update.vert"), varyings, varyingCount);
+	const ui32 gpuDrawProgram = Shader::programLinking(readFile("particle_gpu.vert"), readFile("default.frag"));
+	const ui32 cpuDrawProgram = Shader::programLinking(readFile("particle.vert"), readFile("default.frag"));
+
+	GpuEmitterDesc desc;
+	desc.position = { 640.f, 360.f };
+	desc.radius = 20.f;
+	desc.angle = 1.f;
+	desc.spread = 2.5f;
+	desc.speedMin = 40.f; desc.speedMax = 160.f;
+	desc.lifeMin = 0.4f; desc.lifeMax = 1.6f;
+	desc.rate = 3000.f;
+	desc.gravity = { 0.f, -98.f };
+	desc.drag = 0.3f;
+
+	const float dt = 1.f / 60.f;
+	// every slot is spawned once at most
+	if ((ui32)(desc.rate * dt * steps) + 64 > CAPACITY) steps = (ui32)((CAPACITY - 64) / (desc.rate * dt));
+
+	GpuParticleEmitter gpu(CAPACITY, updateProgram, gpuDrawProgram);
+	gpu.setDesc(desc);
+	gpu.burst(50);
+
+	ParticleSystem cpu(cpuDrawProgram);
+	cpu.setGravity(desc.gravity);
+	cpu.setDrag(desc.drag);
+
+	for (ui32 s = 0; s < steps; s++) {
+		gpu.update(dt);
+
+		// the gpu integrates the living slots and then spawns into the reborn ones, which don't move that step
+		cpu.update(dt);
+		spawn(cpu, gpu.getPending().back());
+	}
+
+	std::vector<float> gpuState, cpuState;
+	gpu.readBack(gpuState);
+	cpu.readBack(cpuState);
+
+	// slot of every cpu particle, or -1 for the slots it has none
+	std::vector<i32> matched(CAPACITY, -1);
+	for (size_t i = 0; i < cpu.size(); i++) matched[(ui32)cpuState[i * ParticleSystem::STATE_FLOATS + 5]] = (i32)i;
+
+	ui32 alive = 0, mismatches = 0;
+	float worstPosition = 0.f, worstLife = 0.f;
+
+	for (ui32 slot = 0; slot < CAPACITY; slot++) {
+		const float* g = gpuState.data() + slot * GpuParticleEmitter::STATE_FLOATS;
+		const bool gpuAlive = g[4] > 0.f;
+
+		if (matched[slot] < 0) {
+			// the cpu has removed it, the gpu keeps it dead in its slot. a life right at zero may round either way
+			if (gpuAlive && g[4] > tolerance) mismatches++;
+			continue;
+		}
+
+		const float* c = cpuState.data() + matched[slot] * ParticleSystem::STATE_FLOATS;
+		alive++;
+
+		if (!gpuAlive && c[4] > tolerance) {
+			mismatches++;
+			continue;
+		}
+
+		worstPosition = fmaxf(worstPosition, fmaxf(fabsf(g[0] - c[0]), fabsf(g[1] - c[1])));
+		worstLife = fmaxf(worstLife, fabsf(g[4] - c[4]));
+
+		if (!near(g[0], c[0], tolerance) || !near(g[1], c[1], tolerance) ||
+			!near(g[2], c[2], tolerance) || !near(g[3], c[3], tolerance) || !near(g[4], c[4], tolerance)) {
+			mismatches++;
+		}
+	}
+
+	std::cout << "steps " << steps << ", particles " << alive << ", worst position error "
+		<< worstPosition << ", worst life error " << worstLife << ", mismatches " << mismatches << std::endl;
+
+	gpu.release();
+	cpu.release();
+	glDeleteProgram(updateProgram);
+	glDeleteProgram(gpuDrawProgram);
+	glDeleteProgram(cpuDrawProgram);
+	glDeleteFramebuffers(1, &framebuffer);
+	glDeleteRenderbuffers(1, &renderbuffer);
+	CurrentBackend() = nullptr;
+	context.release();
+
+	if (mismatches > 0 || alive == 0) {
+		std::cout << "ERROR::PARTICLES::CPU_AND_GPU_DIFFER" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include "Triangulator.h"
+
+using namespace voi;
+
+/*jagged circle, every other point pulled in so half of the corners are reflex. the notches are a few times
+as deep as the spacing between points, like the outline of a region read from map data*/
+static void star(std::vector<Vec2f>& out, ui32 count, float cx, float cy, float radius, bool reversed) {
+	const float depth = fminf(radius * 0.4f, 3.f * 2.f * F_PI * radius / count);
+
+	for (ui32 i = 0; i < count; i++) {
+		const ui32 k = reversed ? count - 1 - i : i;
+		const double a = 2.0 * D_PI * k / count;
+		const float r = (k & 1) ? radius - depth : radius;
+		out.push_back({ cx + (float)(cos(a) * r), cy + (float)(sin(a) * r) });
+	}
+}
+
+static double ringArea(const std::vector<Vec2f>& pts, size_t start, size_t end) {
+	double sum = 0;
+	for (size_t i = start, j = end - 1; i < end; j = i++) {
+		sum += (double)pts[j].x * pts[i].y - (double)pts[i].x * pts[j].y;
+	}
+	return fabs(sum) * 0.5;
+}
+
+static double trianglesArea(const std::vector<Vec2f>& pts, const std::vector<ui32>& idx) {
+	double sum = 0;
+	for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+		const Vec2f& a = pts[idx[i]];
+		const Vec2f& b = pts[idx[i + 1]];
+		const Vec2f& c = pts[idx[i + 2]];
+		sum += fabs(((double)b.x - a.x) * ((double)c.y - a.y) - ((double)c.x - a.x) * ((double)b.y - a.y)) * 0.5;
+	}
+	return sum;
+}
+
+template<typename F>
+static double bestOf(int runs, F&& f) {
+	double best = 1e30;
+	for (int r = 0; r < runs; r++) {
+		const auto t0 = std::chrono::steady_clock::now();
+		f();
+		const auto t1 = std::chrono::steady_clock::now();
+		const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+		best = ms < best ? ms : best;
+	}
+	return best;
+}
+
+int main() {
+	const ui32 sizes[] = { 10, 100, 1000, 10000, 100000 };
+
+	std::cout << std::setw(8) << "verts" << std::setw(7) << "holes" << std::setw(10) << "tris"
+		<< std::setw(14) << "triangulate" << std::setw(12) << "cache hit" << std::setw(12) << "area err" << "\n";
+
+	for (int withHoles = 0; withHoles < 2; withHoles++) {
+		for (ui32 n : sizes) {
+			std::vector<Vec2f> pts;
+			std::vector<ui32> holeStarts;
+
+			if (!withHoles) {
+				star(pts, n, 0.f, 0.f, 1000.f, false);
+			}
+			else {
+				// outline with half of the vertices, the rest split between a grid of small holes
+				const ui32 holeSide = n >= 1000 ? 4 : 2;
+				const ui32 perHole = (n / 2) / (holeSide * holeSide) > 4 ? (n / 2) / (holeSide * holeSide) & ~1u : 4;
+				star(pts, n / 2 > 4 ? n / 2 : 4, 0.f, 0.f, 1000.f, false);
+
+				const float spacing = 800.f / holeSide;
+				for (ui32 y = 0; y < holeSide; y++) {
+					for (ui32 x = 0; x < holeSide; x++) {
+						holeStarts.push_back((ui32)pts.size());
+						star(pts, perHole, -400.f + spacing * (x + 0.5f), -400.f + spacing * (y + 0.5f), spacing * 0.3f, true);
+					}
+				}
+			}
+
+			double expected = ringArea(pts, 0, holeStarts.empty() ? pts.size() : holeStarts[0]);
+			for (size_t h = 0; h < holeStarts.size(); h++) {
+				expected -= ringArea(pts, holeStarts[h], h + 1 < holeStarts.size() ? holeStarts[h + 1] : pts.size());
+			}
+
+			Triangulator triangulator;
+			std::vector<ui32> indices;
+			const int runs = n >= 10000 ? 3 : 20;
+
+			const double ms = bestOf(runs, [&]() {
+				indices.clear();
+				triangulator.triangulate(pts.data(), pts.size(), holeStarts.data(), holeStarts.size(), indices);
+			});
+
+			TriangulationCache cache;
+			cache.get(pts.data(), pts.size(), holeStarts.data(), holeStarts.size());
+			const double hitMs = bestOf(runs, [&]() {
+				cache.get(pts.data(), pts.size(), holeStarts.data(), holeStarts.size());
+			});
+
+			const double err = fabs(trianglesArea(pts, indices) - expected) / expected;
+
+			std::cout << std::setw(8) << pts.size() << std::setw(7) << holeStarts.size() << std::setw(10) << indices.size() / 3
+				<< std::setw(11) << std::fixed << std::setprecision(3) << ms << " ms"
+				<< std::setw(9) << hitMs << " ms"
+				<< std::setw(12) << std::scientific << std::setprecision(1) << err << std::defaultfloat << "\n";
+		}
+	}
+
+	return 0;
+}
@@ -5,8 +5,12 @@ layout (location = 1) in vec4 iColor;
 
 out vec4 vColor;
 
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
 void main(){
 
-	gl_Position = vec4(iPos, 1.0);
+	gl_Position = viewProj * vec4(iPos, 1.0);
 	vColor = iColor;
 }
\ No newline at end of file
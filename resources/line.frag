@@ -0,0 +1,16 @@
+#version 330 core
+
+in vec4 vColor;
+in vec2 vLocal;
+flat in vec3 vSegment;
+flat in int vRound;
+
+out vec4 fColor;
+
+void main(){
+	// round caps and joins are the half discs past the ends of the segment
+	if ((vRound & 1) != 0 && vLocal.x < 0.0 && length(vLocal) > vSegment.y) discard;
+	if ((vRound & 2) != 0 && vLocal.x > vSegment.x && length(vLocal - vec2(vSegment.x, 0.0)) > vSegment.z) discard;
+
+	fColor = vColor;
+}
@@ -0,0 +1,127 @@
+#version 330 core
+
+// previous, start, end and next point of the segment: position, (x, y, z, width), color, (polyline id, style)
+layout (location = 0) in vec2 iPrev;
+layout (location = 8) in vec2 iPrevInfo;
+layout (location = 1) in vec4 iStart;
+layout (location = 2) in vec4 iStartColor;
+layout (location = 3) in vec2 iStartInfo;
+layout (location = 4) in vec4 iEnd;
+layout (location = 5) in vec4 iEndColor;
+layout (location = 6) in vec2 iEndInfo;
+layout (location = 7) in vec2 iNext;
+layout (location = 9) in vec2 iNextInfo;
+
+out vec4 vColor;
+out vec2 vLocal;
+// length, start half width, end half width
+flat out vec3 vSegment;
+// bit 0 round start, bit 1 round end
+flat out int vRound;
+
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
+const int MITER = 0;
+const int BEVEL = 1;
+const int ROUND = 2;
+
+const int BUTT = 0;
+const int SQUARE = 1;
+
+const int GHOST = 16;
+const float MITER_LIMIT = 4.0;
+
+// quad corners as (end, side), then the bevel triangle
+const vec2 CORNERS[6] = vec2[6](
+	vec2(0.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+	vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(0.0, -1.0)
+);
+
+vec2 a, b, dir, n;
+int join, cap;
+
+bool miterFits(vec2 other, out vec2 miter, out float scale){
+	vec2 otherN = vec2(-other.y, other.x);
+	miter = normalize(n + otherN);
+	scale = 1.0 / dot(miter, n);
+	return join == MITER && scale <= MITER_LIMIT;
+}
+
+vec2 corner(bool atEnd, bool isCap, float side){
+	vec2 p = atEnd ? b : a;
+	float hw = (atEnd ? iEnd.w : iStart.w) * 0.5;
+	float outward = atEnd ? 1.0 : -1.0;
+
+	if (isCap) {
+		float extend = cap == BUTT ? 0.0 : hw;
+		return p + dir * extend * outward + n * hw * side;
+	}
+	if (join == ROUND) {
+		return p + dir * hw * outward + n * hw * side;
+	}
+
+	vec2 other = atEnd ? normalize(iNext - b) : normalize(a - iPrev);
+	vec2 miter;
+	float scale;
+	if (miterFits(other, miter, scale)) {
+		return p + miter * hw * scale * side;
+	}
+	return p + n * hw * side;
+}
+
+void main(){
+	int startStyle = int(iStartInfo.y), endStyle = int(iEndInfo.y);
+
+	a = iStart.xy;
+	b = iEnd.xy;
+	float len = length(b - a);
+
+	// ghosts and segments crossing between polylines collapse
+	if (startStyle >= GHOST || endStyle >= GHOST || iStartInfo.x != iEndInfo.x || len == 0.0) {
+		gl_Position = vec4(0.0);
+		return;
+	}
+
+	join = (startStyle >> 2) & 3;
+	cap = startStyle & 3;
+	dir = (b - a) / len;
+	n = vec2(-dir.y, dir.x);
+
+	bool startCap = iPrevInfo.x != iStartInfo.x || iPrev == a;
+	bool endCap = iNextInfo.x != iEndInfo.x || iNext == b;
+
+	vec2 pos;
+	bool atEnd;
+
+	if (gl_VertexID < 6) {
+		vec2 c = CORNERS[gl_VertexID];
+		atEnd = c.x > 0.5;
+		pos = corner(atEnd, atEnd ? endCap : startCap, c.y);
+	}
+	else {
+		// fills the outer side of the joint with the next segment when it is not mitered or rounded
+		atEnd = true;
+		pos = b;
+
+		vec2 other = normalize(iNext - b);
+		vec2 miter;
+		float scale;
+		if (!endCap && join != ROUND && !miterFits(other, miter, scale) && gl_VertexID > 6) {
+			float side = (dir.x * other.y - dir.y * other.x) > 0.0 ? -1.0 : 1.0;
+			vec2 edgeN = gl_VertexID == 7 ? n : vec2(-other.y, other.x);
+			pos = b + edgeN * iEnd.w * 0.5 * side;
+		}
+	}
+
+	bool roundStart = startCap ? cap == ROUND : join == ROUND;
+	bool roundEnd = endCap ? cap == ROUND : join == ROUND;
+
+	vLocal = vec2(dot(pos - a, dir), dot(pos - a, n));
+	vSegment = vec3(len, iStart.w * 0.5, iEnd.w * 0.5);
+	vRound = (roundStart ? 1 : 0) | (roundEnd ? 2 : 0);
+	vColor = atEnd ? iEndColor : iStartColor;
+
+	gl_Position = viewProj * vec4(pos, atEnd ? iEnd.z : iStart.z, 1.0);
+}
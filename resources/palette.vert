@@ -0,0 +1,25 @@
+#version 330 core
+
+layout (location = 0) in vec3 iPos;
+layout (location = 1) in vec4 iColor;
+layout (location = 2) in float iTransform;
+
+out vec4 vColor;
+
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
+// two texels per transform: (a, b, tx) and (c, d, ty)
+uniform samplerBuffer palette;
+
+void main(){
+	int base = int(iTransform) * 2;
+	vec3 row0 = texelFetch(palette, base).xyz;
+	vec3 row1 = texelFetch(palette, base + 1).xyz;
+
+	vec3 local = vec3(iPos.xy, 1.0);
+
+	gl_Position = viewProj * vec4(dot(row0, local), dot(row1, local), iPos.z, 1.0);
+	vColor = iColor;
+}
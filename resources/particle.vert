@@ -0,0 +1,26 @@
+#version 330 core
+
+// one instance per particle, every attribute comes from its own array
+layout (location = 0) in float iX;
+layout (location = 1) in float iY;
+layout (location = 2) in float iSize;
+layout (location = 3) in float iR;
+layout (location = 4) in float iG;
+layout (location = 5) in float iB;
+layout (location = 6) in float iA;
+
+out vec4 vColor;
+
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
+uniform float z;
+
+void main(){
+	// triangle strip corners of a quad centered on the particle
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) - 0.5;
+
+	gl_Position = viewProj * vec4(vec2(iX, iY) + corner * iSize, z, 1.0);
+	vColor = vec4(iR, iG, iB, iA);
+}
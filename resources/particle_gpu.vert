@@ -0,0 +1,27 @@
+#version 330 core
+
+// one instance per slot of the state buffer
+layout (location = 0) in vec2 iPos;
+layout (location = 1) in vec2 iLife;
+
+out vec4 vColor;
+
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
+uniform float z;
+uniform vec4 color;
+uniform vec4 endColor;
+uniform vec2 size;
+
+void main(){
+	// dead slots collapse to a point and are never rasterized
+	float alive = iLife.x > 0.0 ? 1.0 : 0.0;
+	float t = 1.0 - iLife.x / max(iLife.y, 1e-6);
+
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) - 0.5;
+
+	gl_Position = viewProj * vec4(iPos + corner * mix(size.x, size.y, t) * alive, z, 1.0);
+	vColor = mix(color, endColor, t);
+}
@@ -0,0 +1,69 @@
+#version 330 core
+
+// state of one particle, written back through transform feedback into the other buffer
+layout (location = 0) in vec2 iPos;
+layout (location = 1) in vec2 iVel;
+// remaining and total life
+layout (location = 2) in vec2 iLife;
+
+out vec2 oPos;
+out vec2 oVel;
+out vec2 oLife;
+
+uniform float dt;
+uniform float damping;
+uniform vec2 gravity;
+
+// slots spawnStart .. spawnStart + spawnCount, wrapping at capacity, are reborn this step
+uniform uint spawnStart;
+uniform uint spawnCount;
+uniform uint capacity;
+uniform uint seed;
+
+uniform vec2 emitPosition;
+uniform float emitRadius;
+// direction and spread in radians, speed and life as min, max
+uniform vec2 emitAngle;
+uniform vec2 emitSpeed;
+uniform vec2 emitLife;
+
+uint hash(uint x) {
+	x ^= x >> 16; x *= 0x7feb352du;
+	x ^= x >> 15; x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+float random(inout uint state) {
+	state = hash(state);
+	return float(state >> 8) / 16777216.0;
+}
+
+void main(){
+	uint slot = uint(gl_VertexID);
+
+	if ((slot + capacity - spawnStart) % capacity < spawnCount) {
+		uint state = hash(slot ^ hash(seed));
+
+		float angle = emitAngle.x + (random(state) - 0.5) * emitAngle.y;
+		float speed = mix(emitSpeed.x, emitSpeed.y, random(state));
+		float r = emitRadius * sqrt(random(state));
+		float around = random(state) * 6.2831853;
+		float life = mix(emitLife.x, emitLife.y, random(state));
+
+		oPos = emitPosition + r * vec2(cos(around), sin(around));
+		oVel = speed * vec2(cos(angle), sin(angle));
+		oLife = vec2(life, life);
+	}
+	else if (iLife.x > 0.0) {
+		// same integration as the cpu particle system
+		oVel = (iVel + gravity * dt) * damping;
+		oPos = iPos + oVel * dt;
+		oLife = vec2(iLife.x - dt, iLife.y);
+	}
+	else {
+		oPos = iPos;
+		oVel = iVel;
+		oLife = iLife;
+	}
+}
@@ -0,0 +1,43 @@
+#version 330 core
+
+in vec4 vColor;
+in vec2 vLocal;
+// (half width, half height, corner radius or ring thickness, stroke width)
+flat in vec4 vShape;
+flat in int vType;
+
+out vec4 fColor;
+
+const int CIRCLE = 0;
+const int ROUNDED_RECT = 1;
+const int RING = 2;
+
+float roundedBox(vec2 p, vec2 halfSize, float r){
+	vec2 q = abs(p) - halfSize + r;
+	return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - r;
+}
+
+void main(){
+	float d;
+
+	if (vType == ROUNDED_RECT) {
+		d = roundedBox(vLocal, vShape.xy, vShape.z);
+	}
+	else if (vType == RING) {
+		d = abs(length(vLocal) - vShape.x + vShape.z * 0.5) - vShape.z * 0.5;
+	}
+	else {
+		d = length(vLocal) - vShape.x;
+	}
+
+	// outline of the shape drawn inside its edge
+	if (vShape.w > 0.0) {
+		d = abs(d + vShape.w * 0.5) - vShape.w * 0.5;
+	}
+
+	// analytic coverage over one pixel of distance
+	float alpha = clamp(0.5 - d / fwidth(d), 0.0, 1.0);
+	if (alpha <= 0.0) discard;
+
+	fColor = vec4(vColor.rgb, vColor.a * alpha);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+
+layout (location = 0) in vec3 iPos;
+layout (location = 1) in vec4 iColor;
+layout (location = 2) in vec2 iLocal;
+layout (location = 3) in vec4 iShape;
+layout (location = 4) in float iType;
+
+out vec4 vColor;
+out vec2 vLocal;
+flat out vec4 vShape;
+flat out int vType;
+
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
+void main(){
+	gl_Position = viewProj * vec4(iPos, 1.0);
+	vColor = iColor;
+	vLocal = iLocal;
+	vShape = iShape;
+	vType = int(iType);
+}
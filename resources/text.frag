@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec4 vColor;
+in vec2 vTexCord;
+
+out vec4 fColor;
+
+// glyph coverage in the red channel, vTexCord in texels
+uniform sampler2D tex;
+
+void main(){
+	fColor = vec4(vColor.rgb, vColor.a * texture(tex, vTexCord / vec2(textureSize(tex, 0))).r);
+}
@@ -7,8 +7,12 @@ layout (location = 2) in vec2 iTexCord;
 out vec4 vColor;
 out vec2 vTexCord;
 
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
 void main(){
-	gl_Position = vec4(iPos, 1.0);
+	gl_Position = viewProj * vec4(iPos, 1.0);
 	vColor = iColor;
 	vTexCord = iTexCord;
 }
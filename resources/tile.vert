@@ -0,0 +1,21 @@
+#version 330 core
+
+layout (location = 0) in vec2 iPos;
+layout (location = 1) in vec2 iTexCord;
+
+out vec4 vColor;
+out vec2 vTexCord;
+
+layout (std140) uniform Camera {
+	mat4 viewProj;
+};
+
+// the whole tilemap shares one depth
+uniform float z;
+
+void main(){
+	gl_Position = viewProj * vec4(iPos, z, 1.0);
+	// no tint, texture.frag shows the texture as is
+	vColor = vec4(0.0);
+	vTexCord = iTexCord;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+
+namespace voi {
+	/*2D camera, maps world space to clip space through a single view-projection matrix
+	that is shared by every program through the "Camera" uniform block*/
+	class Camera2D {
+	public:
+		enum class Projection {
+			NDC,	// world units are normalized device coordinates, (-1,-1) bottom left
+			PIXELS	// world units are pixels, y grows downwards
+		};
+
+	private:
+		Vec2f position;
+		float zoom = 1.f;
+		float rotation = 0.f;
+
+		Projection projection = Projection::NDC;
+		Vec2f viewport = { 2.f, 2.f };
+
+		bool dirty = true;
+
+		mutable AABB2f bounds;
+		mutable bool boundsDirty = true;
+
+		void touch() { dirty = true; boundsDirty = true; }
+
+	public:
+		Camera2D() {}
+		Camera2D(float width, float height) : viewport(width, height) {}
+
+		// position is the world point that ends in the center of the view
+		Vec2f GetPosition() const { return position; }
+		float GetZoom() const { return zoom; }
+		float GetRotation() const { return rotation; }
+		Projection GetProjection() const { return projection; }
+		Vec2f GetViewport() const { return viewport; }
+
+		void SetPosition(Vec2f _position) { position = _position; touch(); }
+		void Move(Vec2f offset) { position += offset; touch(); }
+		void SetZoom(float _zoom) { zoom = _zoom; touch(); }
+		void SetRotation(float _rotation) { rotation = _rotation; touch(); }
+		void SetProjection(Projection _projection) { projection = _projection; touch(); }
+		void SetViewport(float width, float height) { viewport = { width, height }; touch(); }
+
+		/*pixel projection with the origin on the top left corner of the view, so pixel coordinates
+		can be submitted as they are*/
+		void SetPixelSpace() {
+			projection = Projection::PIXELS;
+			position = { viewport.x * 0.5f, viewport.y * 0.5f };
+			zoom = 1.f;
+			rotation = 0.f;
+			touch();
+		}
+
+		bool IsDirty() const { return dirty; }
+		void ClearDirty() { dirty = false; }
+
+		/*how many pixels a world unit spans on screen*/
+		float PixelScale() const {
+			if (projection == Projection::PIXELS) return zoom;
+			return zoom * viewport.y * 0.5f;
+		}
+
+		/*world to clip affine transform as { a, b, tx, c, d, ty } where
+		clip.x = a * x + b * y + tx and clip.y = c * x + d * y + ty*/
+		void Affine(float out[6]) const {
+			float sx = 1.f, sy = 1.f;
+			if (projection == Projection::PIXELS) {
+				sx = 2.f / viewport.x;
+				sy = -2.f / viewport.y;
+			}
+
+			const float cs = cosf(rotation) * zoom, sn = sinf(rotation) * zoom;
+
+			out[0] = sx * cs;  out[1] = sx * sn;
+			out[3] = -sy * sn; out[4] = sy * cs;
+			out[2] = -(out[0] * position.x + out[1] * position.y);
+			out[5] = -(out[3] * position.x + out[4] * position.y);
+		}
+
+		/*column major mat4 in the layout the "Camera" uniform block expects*/
+		void ViewProjection(float out[16]) const {
+			float m[6];
+			Affine(m);
+
+			out[0] = m[0]; out[1] = m[3]; out[2] = 0.f;  out[3] = 0.f;
+			out[4] = m[1]; out[5] = m[4]; out[6] = 0.f;  out[7] = 0.f;
+			out[8] = 0.f;  out[9] = 0.f;  out[10] = 1.f; out[11] = 0.f;
+			out[12] = m[2]; out[13] = m[5]; out[14] = 0.f; out[15] = 1.f;
+		}
+
+		Vec2f WorldToClip(Vec2f p) const {
+			float m[6];
+			Affine(m);
+			return { m[0] * p.x + m[1] * p.y + m[2], m[3] * p.x + m[4] * p.y + m[5] };
+		}
+		Vec2f ClipToWorld(Vec2f p) const {
+			float m[6];
+			Affine(m);
+
+			const float det = m[0] * m[4] - m[1] * m[3];
+			const float x = p.x - m[2], y = p.y - m[5];
+
+			return { (m[4] * x - m[1] * y) / det, (m[0] * y - m[3] * x) / det };
+		}
+
+		/*world space box that covers everything visible, rotated views get the box of their corners*/
+		const AABB2f& ViewBounds() const {
+			if (boundsDirty) {
+				Vec2f c = ClipToWorld({ -1.f, -1.f });
+				bounds = { c, c };
+				bounds.expand(ClipToWorld({ 1.f, -1.f }));
+				bounds.expand(ClipToWorld({ 1.f,  1.f }));
+				bounds.expand(ClipToWorld({ -1.f, 1.f }));
+				boundsDirty = false;
+			}
+			return bounds;
+		}
+
+		// screen coordinates are window pixels with the origin on the top left corner
+		Vec2f WorldToScreen(Vec2f p) const {
+			Vec2f c = WorldToClip(p);
+			return { (c.x + 1.f) * 0.5f * viewport.x, (1.f - c.y) * 0.5f * viewport.y };
+		}
+		Vec2f ScreenToWorld(Vec2f p) const {
+			return ClipToWorld({ p.x / viewport.x * 2.f - 1.f, 1.f - p.y / viewport.y * 2.f });
+		}
+	};
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Pixel.h"
+#include "Culling.h"
+
+namespace voi {
+	/*primitives recorded away from the context thread. each worker owns one list and writes whole vertices into
+	it, in the layouts of the solid and single texture batches, with no locking and no gl call. the engine later
+	appends the lists to its batches in the order of their ids, so the frame comes out the same whatever order
+	the workers finished in*/
+	class CommandList {
+	public:
+		struct Stream {
+			std::vector<float> vertices;
+			// relative to the first vertex of the stream
+			std::vector<ui32> elements;
+			ui32 vertexCount = 0;
+
+			void clear() {
+				vertices.clear();
+				elements.clear();
+				vertexCount = 0;
+			}
+		};
+
+	private:
+		Stream solid;
+		// one stream per texture batch, the same ids AddTexture returns
+		std::vector<Stream> textured;
+		ui32 textureBatch = 0;
+
+		AABB2f view;
+		bool cull = false;
+		CullStats stats;
+
+	public:
+		Pixel drawColor = { 1.0f,1.0f,1.0f,1.0f };
+
+		/*empties the list, primitives outside of view are dropped while recording when cull is set*/
+		void reset(const AABB2f& _view, bool _cull) {
+			solid.clear();
+			for (Stream& stream : textured) stream.clear();
+			view = _view;
+			cull = _cull;
+			stats = {};
+		}
+
+		bool empty() const {
+			if (solid.vertexCount > 0) return false;
+			for (const Stream& stream : textured) {
+				if (stream.vertexCount > 0) return false;
+			}
+			return true;
+		}
+
+		const Stream& getSolid() const { return solid; }
+		const std::vector<Stream>& getTextured() const { return textured; }
+		CullStats getCullStats() const { return stats; }
+
+		void ChooseCurrentTextures(ui32 batch) { textureBatch = batch; }
+
+		void FillTriangle(Vec2f p1, Vec2f p2, Vec2f p3, float z = 0) {
+			if (culled(p1, p2, p3, p3)) return;
+
+			const Vec2f p[3] = { p1, p2, p3 };
+			const ui32 elements[3] = { 0, 1, 2 };
+			writeSolid(p, 3, elements, 3, z);
+		}
+
+		void FillQuad(Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4, float z = 0) {
+			if (culled(p1, p2, p3, p4)) return;
+
+			const Vec2f p[4] = { p1, p2, p3, p4 };
+			const ui32 elements[6] = { 0, 1, 2, 2, 3, 0 };
+			writeSolid(p, 4, elements, 6, z);
+		}
+
+		void FillRect(float x, float y, float w, float h, float z = 0) {
+			FillQuad({ x, y }, { x + w, y }, { x + w, y + h }, { x, y + h }, z);
+		}
+
+		void TextureQuad(Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4, float z = 0,
+			Vec2f t1 = { 0.0,0.0 }, Vec2f t2 = { 1.0,0.0 }, Vec2f t3 = { 1.0,1.0 }, Vec2f t4 = { 0.0,1.0 }) {
+			if (culled(p1, p2, p3, p4)) return;
+
+			if (textureBatch >= textured.size()) textured.resize(textureBatch + 1);
+			Stream& stream = textured[textureBatch];
+
+			const Vec2f p[4] = { p1, p2, p3, p4 };
+			const Vec2f t[4] = { t1, t2, t3, t4 };
+			for (ui32 i = 0; i < 4; i++) {
+				stream.vertices.insert(stream.vertices.end(), {
+					p[i].x, p[i].y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t[i].x, t[i].y
+				});
+			}
+
+			const ui32 b = stream.vertexCount;
+			stream.elements.insert(stream.elements.end(), { b, b + 1, b + 2, b + 2, b + 3, b });
+			stream.vertexCount += 4;
+		}
+
+		void TextureRect(float x, float y, float w, float h, float z = 0,
+			Vec2f t1 = { 0.0,0.0 }, Vec2f t2 = { 1.0,0.0 }, Vec2f t3 = { 1.0,1.0 }, Vec2f t4 = { 0.0,1.0 }) {
+			TextureQuad({ x, y }, { x + w, y }, { x + w, y + h }, { x, y + h }, z, t1, t2, t3, t4);
+		}
+
+		/*convex outline, fanned from its first point*/
+		void FillConvex(const Vec2f* points, size_t count, float z = 0) {
+			if (count < 3) return;
+
+			AABB2f box(points[0], points[0]);
+			for (size_t i = 1; i < count; i++) box.expand(points[i]);
+			if (culled(box.min.x, box.min.y, box.max.x, box.max.y)) return;
+
+			const ui32 b = solid.vertexCount;
+			for (ui32 i = 1; i + 1 < count; i++) {
+				solid.elements.insert(solid.elements.end(), { b, b + i, b + i + 1 });
+			}
+			for (size_t i = 0; i < count; i++) pushSolid(points[i], z);
+		}
+
+	private:
+		bool culled(float minX, float minY, float maxX, float maxY) {
+			stats.submitted++;
+
+			if (cull && OutsideView(view, minX, minY, maxX, maxY)) {
+				stats.culled++;
+				return true;
+			}
+			return false;
+		}
+		bool culled(Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4) {
+			return culled(
+				fminf(fminf(p1.x, p2.x), fminf(p3.x, p4.x)), fminf(fminf(p1.y, p2.y), fminf(p3.y, p4.y)),
+				fmaxf(fmaxf(p1.x, p2.x), fmaxf(p3.x, p4.x)), fmaxf(fmaxf(p1.y, p2.y), fmaxf(p3.y, p4.y))
+			);
+		}
+
+		void pushSolid(Vec2f p, float z) {
+			solid.vertices.insert(solid.vertices.end(), { p.x, p.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a });
+			solid.vertexCount++;
+		}
+
+		void writeSolid(const Vec2f* points, ui32 count, const ui32* elements, ui32 elementCount, float z) {
+			const ui32 b = solid.vertexCount;
+			for (ui32 i = 0; i < elementCount; i++) solid.elements.push_back(b + elements[i]);
+			for (ui32 i = 0; i < count; i++) pushSolid(points[i], z);
+		}
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define VOI_CULL_SSE
+#endif
+
+#include "utilDefs.h"
+#include "Lineal.h"
+
+namespace voi {
+	/*axis aligned rectangle as the draw functions take it, width and height may be negative*/
+	struct Rect2D {
+		float x, y, w, h;
+	};
+
+	/*primitives handed to the draw functions against the ones dropped for being outside of the view*/
+	struct CullStats {
+		ui64 submitted = 0;
+		ui64 culled = 0;
+
+		ui64 emitted() const { return submitted - culled; }
+	};
+
+	inline bool OutsideView(const AABB2f& view, float minX, float minY, float maxX, float maxY) {
+		return maxX < view.min.x || minX > view.max.x || maxY < view.min.y || minY > view.max.y;
+	}
+
+	/*writes the index of every rect that overlaps the view into visible, returns how many were written.
+	visible needs room for count indices*/
+	inline size_t CullRects(const Rect2D* rects, size_t count, const AABB2f& view, ui32* visible) {
+		size_t written = 0;
+		size_t i = 0;
+
+#ifdef VOI_CULL_SSE
+		const __m128 viewMinX = _mm_set1_ps(view.min.x), viewMinY = _mm_set1_ps(view.min.y);
+		const __m128 viewMaxX = _mm_set1_ps(view.max.x), viewMaxY = _mm_set1_ps(view.max.y);
+
+		// four rects per iteration, transposed from {x,y,w,h} rows into x, y, w and h lanes
+		for (; i + 4 <= count; i += 4) {
+			__m128 x = _mm_loadu_ps(&rects[i].x);
+			__m128 y = _mm_loadu_ps(&rects[i + 1].x);
+			__m128 w = _mm_loadu_ps(&rects[i + 2].x);
+			__m128 h = _mm_loadu_ps(&rects[i + 3].x);
+			_MM_TRANSPOSE4_PS(x, y, w, h);
+
+			const __m128 x2 = _mm_add_ps(x, w), y2 = _mm_add_ps(y, h);
+			const __m128 minX = _mm_min_ps(x, x2), maxX = _mm_max_ps(x, x2);
+			const __m128 minY = _mm_min_ps(y, y2), maxY = _mm_max_ps(y, y2);
+
+			const __m128 inside = _mm_and_ps(
+				_mm_and_ps(_mm_cmple_ps(minX, viewMaxX), _mm_cmpge_ps(maxX, viewMinX)),
+				_mm_and_ps(_mm_cmple_ps(minY, viewMaxY), _mm_cmpge_ps(maxY, viewMinY))
+			);
+
+			const int mask = _mm_movemask_ps(inside);
+			for (int lane = 0; lane < 4; lane++) {
+				if (mask & (1 << lane)) visible[written++] = (ui32)(i + lane);
+			}
+		}
+#endif
+
+		for (; i < count; i++) {
+			const Rect2D& r = rects[i];
+			const float x2 = r.x + r.w, y2 = r.y + r.h;
+
+			if (!OutsideView(view, r.x < x2 ? r.x : x2, r.y < y2 ? r.y : y2, r.x > x2 ? r.x : x2, r.y > y2 ? r.y : y2)) {
+				visible[written++] = (ui32)i;
+			}
+		}
+
+		return written;
+	}
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <cstring>
+#include <iostream>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Path.h"
+#include "FrameStats.h"
+#include "TrueType.h"
+
+namespace voi {
+	/*single channel texture shared by every font. glyphs are packed in shelves as they are first drawn,
+	the texture doubles its height when it runs out of room, so positions in pixels stay valid.
+	new glyphs only go to the cpu copy, the rows they touched are sent once before drawing*/
+	class GlyphAtlas {
+	public:
+		/*rows changed since the previous capture, so they can be sent from the thread that draws*/
+		struct Data {
+			std::vector<ui8> rows;
+			ui32 top = 0;
+			ui32 count = 0;
+			// the texture is allocated again at this height first when it differs
+			ui32 height = 0;
+		};
+
+	private:
+		ui32 texture = 0;
+		ui32 width = 0;
+		ui32 height = 0;
+		ui32 maxHeight = 0;
+		// height of the texture, only touched by the thread that draws
+		ui32 textureHeight = 0;
+
+		// copy of the texture, to carry the glyphs over when it grows
+		std::vector<ui8> pixels;
+		ui32 dirtyTop = 0, dirtyBottom = 0;
+		Data staged;
+
+		ui32 shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+	public:
+		void init(ui32 _width = 512, ui32 _height = 512, ui32 _maxHeight = 4096) {
+			width = _width;
+			height = _height;
+			maxHeight = _maxHeight;
+			pixels.assign((size_t)width * height, 0);
+
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+			markDirty(0, height);
+			flush();
+		}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			if (texture != 0) glDeleteTextures(1, &texture);
+			texture = 0;
+		}
+
+		ui32 getTexture() const { return texture; }
+		ui32 getWidth() const { return width; }
+		ui32 getHeight() const { return height; }
+
+		/*copies a w * h coverage bitmap into the atlas, false when it doesn't fit anymore*/
+		bool add(const ui8* bitmap, ui32 w, ui32 h, ui32& x, ui32& y) {
+			if (w > width) return false;
+
+			if (shelfX + w > width) {
+				shelfY += shelfHeight;
+				shelfX = 0;
+				shelfHeight = 0;
+			}
+			while (shelfY + h > height) {
+				if (height * 2 > maxHeight) {
+					std::cout << "ERROR::FONT::GLYPH_ATLAS_FULL" << std::endl;
+					return false;
+				}
+				grow();
+			}
+
+			x = shelfX;
+			y = shelfY;
+			shelfX += w;
+			shelfHeight = h > shelfHeight ? h : shelfHeight;
+
+			for (ui32 row = 0; row < h; row++) {
+				std::memcpy(pixels.data() + (size_t)(y + row) * width + x, bitmap + (size_t)row * w, w);
+			}
+			markDirty(y, y + h);
+
+			return true;
+		}
+
+		/*sends the rows changed since the last call*/
+		void flush() {
+			capture(staged);
+			upload(staged);
+		}
+
+		void capture(Data& data) {
+			data.height = height;
+			data.top = dirtyTop;
+			data.count = dirtyBottom - dirtyTop;
+			data.rows.assign(pixels.begin() + (size_t)dirtyTop * width, pixels.begin() + (size_t)dirtyBottom * width);
+
+			dirtyTop = dirtyBottom = 0;
+		}
+
+		void upload(const Data& data) {
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			if (data.height != textureHeight) {
+				textureHeight = data.height;
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, textureHeight, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+			}
+			if (data.count > 0) {
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, data.top, width, data.count, GL_RED, GL_UNSIGNED_BYTE, data.rows.data());
+				DrawCounters().textureBytes += (ui64)width * data.count;
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+	private:
+		void grow() {
+			height *= 2;
+			pixels.resize((size_t)width * height, 0);
+			// the texture is allocated again, every row goes
+			markDirty(0, height);
+		}
+
+		void markDirty(ui32 top, ui32 bottom) {
+			if (dirtyTop >= dirtyBottom) {
+				dirtyTop = top;
+				dirtyBottom = bottom;
+			}
+			else {
+				dirtyTop = top < dirtyTop ? top : dirtyTop;
+				dirtyBottom = bottom > dirtyBottom ? bottom : dirtyBottom;
+			}
+		}
+	};
+
+	/*glyph quad relative to the pen position on the baseline, y pointing down, and its place in the atlas
+	in pixels*/
+	struct Glyph {
+		float x0, y0, x1, y1;
+		ui16 ax, ay, aw, ah;
+		float advance;
+		ui32 index;
+	};
+
+	/*string laid out once, glyph quads relative to the top left corner of the text*/
+	struct TextLayout {
+		std::vector<Glyph> glyphs;
+		Vec2f size;
+		ui64 lastUsed = 0;
+	};
+
+	/*TrueType font at one pixel size. glyphs are rasterized into the atlas the first time they are used,
+	and the layouts of strings are kept while they keep being drawn. the font lets go of a layout unused for
+	maxAge frames, copies of the pointer held elsewhere keep it alive*/
+	class Font {
+		TrueType file;
+		float pixelHeight = 0.f;
+		float scale = 0.f;
+
+		std::unordered_map<ui32, Glyph> glyphs;
+		std::unordered_map<std::string, std::shared_ptr<TextLayout>> layouts;
+
+		ui64 frame = 0;
+		ui64 maxAge = 120;
+
+		// scratch of the rasterizer
+		Path outline;
+		std::vector<Vec2f> flat;
+		std::vector<ui32> contourStarts;
+		std::vector<float> accumulation;
+		std::vector<ui8> bitmap;
+
+	public:
+		bool load(const std::string& path, float _pixelHeight) {
+			if (!file.load(path)) return false;
+
+			pixelHeight = _pixelHeight;
+			scale = pixelHeight / file.unitsPerEm;
+			return true;
+		}
+
+		float getPixelHeight() const { return pixelHeight; }
+		float ascent() const { return file.ascender * scale; }
+		float descent() const { return -file.descender * scale; }
+		float lineHeight() const { return (file.ascender - file.descender + file.lineGap) * scale; }
+
+		const Glyph& glyph(ui32 codepoint, GlyphAtlas& atlas) {
+			auto it = glyphs.find(codepoint);
+			if (it != glyphs.end()) return it->second;
+
+			Glyph& g = glyphs[codepoint];
+			g = {};
+			g.index = file.glyphIndex(codepoint);
+			g.advance = file.advance(g.index) * scale;
+
+			i32 xMin, yMin, xMax, yMax;
+			if (!file.bounds(g.index, xMin, yMin, xMax, yMax)) return g;
+
+			// one pixel of empty border so linear filtering never reads the neighbours in the atlas
+			const float left = floorf(xMin * scale) - 1.f, top = floorf(-yMax * scale) - 1.f;
+			const ui32 w = (ui32)(ceilf(xMax * scale) - left) + 1;
+			const ui32 h = (ui32)(ceilf(-yMin * scale) - top) + 1;
+
+			outline.clear();
+			flat.clear();
+			contourStarts.clear();
+
+			const float m[4] = { scale, 0.f, 0.f, -scale };
+			file.outline(g.index, outline, m, { -left, -top });
+			outline.flatten(0.1f, flat, contourStarts);
+
+			RasterizeCoverage(flat, contourStarts, w, h, accumulation, bitmap);
+
+			ui32 ax, ay;
+			if (!atlas.add(bitmap.data(), w, h, ax, ay)) return g;
+
+			g.x0 = left; g.y0 = top;
+			g.x1 = left + w; g.y1 = top + h;
+			g.ax = (ui16)ax; g.ay = (ui16)ay;
+			g.aw = (ui16)w; g.ah = (ui16)h;
+
+			return g;
+		}
+
+		/*lays out utf-8 text with kerning, lines split at '\n'. the result is kept for later calls with the
+		same text*/
+		const std::shared_ptr<TextLayout>& layout(const std::string& text, GlyphAtlas& atlas) {
+			auto it = layouts.find(text);
+			if (it != layouts.end()) {
+				it->second->lastUsed = frame;
+				return it->second;
+			}
+
+			std::shared_ptr<TextLayout>& kept = layouts[text];
+			kept = std::make_shared<TextLayout>();
+			TextLayout& l = *kept;
+			l.lastUsed = frame;
+
+			float penX = 0.f, penY = ascent(), width = 0.f;
+			ui32 previous = 0;
+
+			size_t i = 0;
+			while (i < text.size()) {
+				const ui32 codepoint = DecodeUtf8(text, i);
+
+				if (codepoint == '\n') {
+					width = penX > width ? penX : width;
+					penX = 0.f;
+					penY += lineHeight();
+					previous = 0;
+					continue;
+				}
+
+				const Glyph& g = glyph(codepoint, atlas);
+				if (previous != 0) penX += file.kerning(previous, g.index) * scale;
+				previous = g.index;
+
+				if (g.aw > 0) {
+					Glyph placed = g;
+					placed.x0 += penX; placed.x1 += penX;
+					placed.y0 += penY; placed.y1 += penY;
+					l.glyphs.push_back(placed);
+				}
+				penX += g.advance;
+			}
+
+			width = penX > width ? penX : width;
+			l.size = { width, penY + descent() };
+
+			return kept;
+		}
+
+		void endFrame() {
+			frame++;
+
+			for (auto it = layouts.begin(); it != layouts.end();) {
+				if (frame - it->second->lastUsed > maxAge) it = layouts.erase(it);
+				else ++it;
+			}
+		}
+
+		/*next codepoint of s from i, malformed bytes come out as U+FFFD*/
+		static ui32 DecodeUtf8(const std::string& s, size_t& i) {
+			const ui8 c = (ui8)s[i++];
+			if (c < 0x80) return c;
+
+			ui32 extra = c >= 0xf0 ? 3 : (c >= 0xe0 ? 2 : (c >= 0xc0 ? 1 : 0));
+			if (extra == 0) return 0xfffd;
+
+			ui32 codepoint = c & (0x3f >> extra);
+			while (extra-- > 0) {
+				if (i >= s.size() || ((ui8)s[i] & 0xc0) != 0x80) return 0xfffd;
+				codepoint = (codepoint << 6) | ((ui8)s[i++] & 0x3f);
+			}
+			return codepoint;
+		}
+	};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+namespace voi {
+	/*holds frames to a fixed rate. sleeping can overshoot by about a scheduler tick, so the wait sleeps until
+	spinMargin seconds are left and spins through the rest*/
+	class FrameLimiter {
+		double interval = 0.0;
+		double spinMargin = 0.001;
+		double next = 0.0;
+
+	public:
+		static double Now() {
+			return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		/*0 turns the limit off*/
+		void setRate(float framesPerSecond) {
+			interval = framesPerSecond > 0.f ? 1.0 / framesPerSecond : 0.0;
+		}
+		float getRate() const { return interval > 0.0 ? (float)(1.0 / interval) : 0.f; }
+
+		void setSpinMargin(double seconds) { spinMargin = seconds > 0.0 ? seconds : 0.0; }
+
+		/*blocks until a whole interval went by since the previous frame was let through*/
+		void wait() {
+			if (interval <= 0.0) return;
+
+			double now = Now();
+			// more than a frame late, counting starts again instead of rushing frames to catch up
+			if (now - next > interval) next = now;
+
+			while (next - now > spinMargin) {
+				std::this_thread::sleep_for(std::chrono::duration<double>(next - now - spinMargin));
+				now = Now();
+			}
+			while (now < next) now = Now();
+
+			next += interval;
+		}
+	};
+}
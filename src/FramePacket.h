@@ -0,0 +1,130 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+#include "utilDefs.h"
+#include "Pixel.h"
+#include "RenderBatch.hpp"
+#include "LineBatch.hpp"
+#include "PathBatch.hpp"
+#include "TransformPalette.h"
+#include "Font.h"
+#include "Tilemap.h"
+#include "ParticleSystem.h"
+#include "GpuParticleEmitter.h"
+
+namespace voi {
+	/*object drawn by the render thread with what was captured from it*/
+	template<typename T>
+	struct PacketEntry {
+		T* object = nullptr;
+		typename T::Data data;
+	};
+
+	/*everything the render thread needs to draw one frame, captured after Update. nothing in it points at
+	memory the simulation keeps writing*/
+	struct FramePacket {
+		ui64 frame = 0;
+		// when the input this frame reacted to was read
+		double inputTime = 0.0;
+
+		bool clear = false;
+		Pixel clearColor;
+
+		bool cameraChanged = false;
+		float viewProj[16];
+
+		// the frame is read back once drawn, and written as a png when the path isn't empty
+		bool capture = false;
+		std::string capturePath;
+
+		// gl work asked for during Update, run before anything is drawn
+		std::vector<std::function<void()>> commands;
+
+		TransformPalette::Data palette;
+		GlyphAtlas::Data glyphs;
+
+		std::vector<PacketEntry<Tilemap>> tilemaps;
+		std::vector<RenderBatch::Data> batches;
+		std::vector<PacketEntry<ParticleSystem>> particles;
+		std::vector<PacketEntry<GpuParticleEmitter>> emitters;
+		LineBatch::Data lines;
+		PathBatch::Data paths;
+		// stats overlay, empty when it is off
+		std::vector<RenderBatch::Data> overlay;
+	};
+
+	/*bounded hand-off of packets between the thread running Update and the one drawing. up to latency packets
+	wait or are being drawn while one more is filled, acquiring blocks while they are all taken. packets go
+	back to the free list once drawn, so their vectors keep their memory*/
+	class FrameQueue {
+		std::vector<FramePacket> packets;
+		std::deque<FramePacket*> free;
+		std::deque<FramePacket*> ready;
+
+		std::mutex mutex;
+		std::condition_variable changed;
+		bool closed = false;
+
+	public:
+		void init(ui32 latency) {
+			packets.clear();
+			packets.resize(latency + 1);
+
+			free.clear();
+			ready.clear();
+			for (FramePacket& packet : packets) free.push_back(&packet);
+			closed = false;
+		}
+
+		/*free packet to fill, waits while latency packets are ahead*/
+		FramePacket* acquire() {
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this]() { return !free.empty(); });
+
+			FramePacket* packet = free.front();
+			free.pop_front();
+			return packet;
+		}
+
+		void submit(FramePacket* packet) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				ready.push_back(packet);
+			}
+			changed.notify_all();
+		}
+
+		/*oldest filled packet, nullptr once closed and drained*/
+		FramePacket* next() {
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this]() { return !ready.empty() || closed; });
+			if (ready.empty()) return nullptr;
+
+			FramePacket* packet = ready.front();
+			ready.pop_front();
+			return packet;
+		}
+
+		void release(FramePacket* packet) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				free.push_back(packet);
+			}
+			changed.notify_all();
+		}
+
+		void close() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				closed = true;
+			}
+			changed.notify_all();
+		}
+	};
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "utilDefs.h"
+
+namespace voi {
+	/*what the gpu was asked for in one frame*/
+	struct DrawStats {
+		ui64 drawCalls = 0;
+		// vertices read by the draws, instanced ones count every instance
+		ui64 vertices = 0;
+		ui64 indices = 0;
+
+		// bytes sent to vertex and element buffers, to textures and to every other buffer
+		ui64 vertexBytes = 0;
+		ui64 elementBytes = 0;
+		ui64 textureBytes = 0;
+		ui64 otherBytes = 0;
+
+		ui64 textureBinds = 0;
+		ui64 programSwitches = 0;
+		// gpu buffers allocated again because their content changed size
+		ui64 bufferReallocations = 0;
+
+		void countDraw(ui64 vertexCount, ui64 indexCount = 0) {
+			drawCalls++;
+			vertices += vertexCount;
+			indices += indexCount;
+		}
+	};
+
+	/*counters of the frame being drawn. only the thread owning the context writes them, so they are plain
+	adds with nothing to synchronize*/
+	inline DrawStats& DrawCounters() {
+		static DrawStats stats;
+		return stats;
+	}
+
+	/*cpu times of the last frames, oldest ones are overwritten*/
+	class FrameTimes {
+		std::vector<float> times;
+		std::vector<float> sorted;
+		ui32 next = 0;
+		ui32 count = 0;
+
+	public:
+		FrameTimes(ui32 window = 240) : times(window > 0 ? window : 1, 0.f) {}
+
+		void add(float seconds) {
+			times[next] = seconds;
+			next = (next + 1) % (ui32)times.size();
+			count = count < times.size() ? count + 1 : count;
+		}
+
+		ui32 size() const { return count; }
+
+		/*i-th time of the window, 0 is the oldest*/
+		float get(ui32 i) const {
+			if (i >= count) {
+				throw "Outside of range Exception";
+			}
+			const ui32 first = count < times.size() ? 0 : next;
+			return times[(first + i) % times.size()];
+		}
+
+		/*time under which percent of the window falls, 0 with no frames yet*/
+		float percentile(float percent) {
+			if (count == 0) return 0.f;
+
+			sorted.assign(times.begin(), times.begin() + count);
+			size_t k = (size_t)(percent * 0.01f * (count - 1) + 0.5f);
+			k = k < count ? k : count - 1;
+
+			std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+			return sorted[k];
+		}
+	};
+
+	struct FrameStats {
+		// counters of the last frame the gpu was given
+		DrawStats draw;
+		// batches whose vertex or element storage had to grow during the last Update
+		ui64 batchGrowths = 0;
+
+		// seconds, of the last frame and over the window of FrameTimes
+		float frameTime = 0.f;
+		float frameTimeP50 = 0.f;
+		float frameTimeP95 = 0.f;
+		float frameTimeP99 = 0.f;
+
+		// seconds the gpu spent on the last frame it finished
+		float gpuTime = 0.f;
+	};
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <deque>
+#include <vector>
+#include <atomic>
+
+#include "utilDefs.h"
+
+namespace voi {
+	/*bounds how many frames the gpu may be behind. a fence goes in after every swap, and the frame waits for
+	the one framesInFlight frames older, so 1 waits for the gpu to finish each frame before the next one reads
+	input. a timestamp query next to every fence tells when the gpu really finished the frame, taken back to
+	the cpu clock to measure the time from reading input to the frame being done. another one taken when the
+	frame starts drawing gives the gpu time of the frame*/
+	class FrameSync {
+		struct Frame {
+			GLsync fence;
+			ui32 query;
+			// 0 when beginFrame wasn't called
+			ui32 startQuery;
+			double inputTime;
+		};
+
+		std::deque<Frame> inFlight;
+		std::vector<ui32> freeQueries;
+		ui32 startQuery = 0;
+		ui32 depth = 2;
+
+		// the same instant on both clocks, gpu in nanoseconds
+		GLint64 gpuReference = 0;
+		double cpuReference = 0.0;
+
+		std::atomic<float> latency{ 0.f };
+		std::atomic<float> gpuTime{ 0.f };
+
+	public:
+		static constexpr ui32 MOST_IN_FLIGHT = 8;
+
+		/*0 only waits once MOST_IN_FLIGHT frames are behind, latency is still measured as they finish*/
+		void setDepth(ui32 framesInFlight) {
+			depth = framesInFlight < MOST_IN_FLIGHT ? framesInFlight : (ui32)MOST_IN_FLIGHT;
+		}
+		ui32 getDepth() const { return depth; }
+
+		/*seconds from reading the input of the last finished frame to the gpu being done with it*/
+		float getLatency() const { return latency.load(std::memory_order_relaxed); }
+
+		/*seconds between the gpu reaching the first and the last command of the last finished frame, idle gaps
+		waiting on the cpu included*/
+		float getGpuTime() const { return gpuTime.load(std::memory_order_relaxed); }
+
+		/*before the first command of the frame is issued*/
+		void beginFrame() {
+			if (startQuery == 0) startQuery = takeQuery();
+			glQueryCounter(startQuery, GL_TIMESTAMP);
+		}
+
+		/*right after the swap, on the thread owning the context. now is the cpu time of this moment on the clock
+		inputTime was taken from*/
+		void endFrame(double inputTime, double now) {
+			glGetInteger64v(GL_TIMESTAMP, &gpuReference);
+			cpuReference = now;
+
+			const ui32 query = takeQuery();
+			glQueryCounter(query, GL_TIMESTAMP);
+
+			inFlight.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), query, startQuery, inputTime });
+			startQuery = 0;
+
+			const size_t limit = depth > 0 ? depth : (size_t)MOST_IN_FLIGHT;
+			while (inFlight.size() >= limit) retire(true);
+
+			// frames already done are counted without waiting
+			while (!inFlight.empty() && retire(false));
+		}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			for (const Frame& frame : inFlight) {
+				glDeleteSync(frame.fence);
+				freeQueries.push_back(frame.query);
+				if (frame.startQuery != 0) freeQueries.push_back(frame.startQuery);
+			}
+			inFlight.clear();
+			if (startQuery != 0) freeQueries.push_back(startQuery);
+			startQuery = 0;
+
+			if (!freeQueries.empty()) glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+			freeQueries.clear();
+		}
+
+	private:
+		ui32 takeQuery() {
+			ui32 query;
+			if (freeQueries.empty()) glGenQueries(1, &query);
+			else {
+				query = freeQueries.back();
+				freeQueries.pop_back();
+			}
+			return query;
+		}
+
+		/*takes the oldest frame out once the gpu is done with it, returns false if it isn't and wait is off*/
+		bool retire(bool wait) {
+			Frame& frame = inFlight.front();
+
+			if (wait) {
+				// the first wait flushes the fence, then it is a plain wait
+				GLenum result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+				while (result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(frame.fence, 0, 1000000000);
+			}
+			else if (glClientWaitSync(frame.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+				return false;
+			}
+
+			// the query was issued before the fence, its result is ready
+			GLuint64 done = 0;
+			glGetQueryObjectui64v(frame.query, GL_QUERY_RESULT, &done);
+
+			const double doneCpu = cpuReference + (double)((GLint64)done - gpuReference) * 1e-9;
+			latency.store((float)(doneCpu - frame.inputTime), std::memory_order_relaxed);
+
+			if (frame.startQuery != 0) {
+				GLuint64 start = 0;
+				glGetQueryObjectui64v(frame.startQuery, GL_QUERY_RESULT, &start);
+				gpuTime.store((float)((double)(done - start) * 1e-9), std::memory_order_relaxed);
+				freeQueries.push_back(frame.startQuery);
+			}
+
+			glDeleteSync(frame.fence);
+			freeQueries.push_back(frame.query);
+			inFlight.pop_front();
+			return true;
+		}
+	};
+}
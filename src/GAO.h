@@ -7,6 +7,8 @@
 #include "Lineal.h"
 
 #include "Pixel.h"
+#include "FrameStats.h"
+#include "RenderBackend.h"
 
 class GAO {
 
@@ -28,25 +30,25 @@ class GAO {
 public:
 	GAO(uint32_t count): COUNT(count){
 
-		glGenVertexArrays(COUNT, VAOs);
-		glGenBuffers(COUNT, VBOs);
-		glGenBuffers(COUNT, EBOs);
+		voi::RenderBackend& backend = voi::Backend();
+		backend.createVertexArrays(COUNT, VAOs);
+		backend.createBuffers(COUNT, VBOs);
+		backend.createBuffers(COUNT, EBOs);
 		for (int i = 0; i < COUNT; i++) {
-			glBindVertexArray(VAOs[i]);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOs[i]);
+			backend.vertexLayout(VAOs[i], VBOs[i], EBOs[i], {});
 		}
 	}
 	~GAO() {
 		if (VAOs != nullptr) {
-			glDeleteVertexArrays(COUNT, VAOs);
+			voi::Backend().deleteVertexArrays(COUNT, VAOs);
 			delete[] VAOs;
 		}
 		if (VBOs != nullptr) {
-			glDeleteBuffers(COUNT, VBOs);
+			voi::Backend().deleteBuffers(COUNT, VBOs);
 			delete[] VBOs;
 		}
 		if (EBOs != nullptr) {
-			glDeleteBuffers(COUNT, EBOs);
+			voi::Backend().deleteBuffers(COUNT, EBOs);
 			delete[] EBOs;
 		}
 
@@ -73,37 +75,9 @@ public:
 		return 0;
 	}
 
-	void bindVao(uint32_t i){
-		if (i < COUNT) {
-			glBindVertexArray(VAOs[i]);
-		}
-		else {
-			throw "Outside of range Exception";
-		}
-	}
-	void bindBuffer(uint32_t i) {
-		if (i < COUNT) {
-			glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
-		}
-		else {
-			throw "Outside of range Exception";
-		}
-	}
-	void bind(uint32_t i) {
-		if (i < COUNT) {
-			glBindVertexArray(VAOs[i]);
-			glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
-		}
-		else {
-			throw "Outside of range Exception";
-		}
-	}
 	void enable(uint32_t i, const std::vector<uint32_t>& atrrs) {
 		if (i < COUNT) {
-			bindVao(i);
-			for (auto n : atrrs) {
-				glEnableVertexAttribArray(n);
-			}
+			voi::Backend().enableAttributes(VAOs[i], atrrs);
 		}
 		else {
 			throw "Outside of range Exception";
@@ -112,26 +86,31 @@ public:
 
 	void setElBufferData(uint32_t i, const std::vector<uint32_t>& elData, GLenum usage, bool resize = false) {
 		if (i < COUNT) {
-			bindVao(i);
+			voi::RenderBackend& backend = voi::Backend();
 
 			const size_t prevCapacity = EBOsInfo[i].capacity;
 			const size_t newSize = elData.size() * sizeof(uint32_t);
+			voi::DrawCounters().elementBytes += newSize;
 
 			if (resize || newSize != prevCapacity) {
+				voi::DrawCounters().bufferReallocations++;
 				if (newSize < 1000 * sizeof(uint32_t)) {
-					glBufferData(GL_ELEMENT_ARRAY_BUFFER, 1000 * sizeof(uint32_t), elData.data(), EBOsInfo[i].usage);
+					/*the minimum size is bigger than elData, only what it holds is read. the frame packets of the
+					render thread copy just the indices in use, so reading past them there runs off the allocation*/
+					backend.bufferData(EBOs[i], 1000 * sizeof(uint32_t), NULL, EBOsInfo[i].usage);
+					backend.bufferSubData(EBOs[i], 0, newSize, elData.data());
 					EBOsInfo[i].capacity = 1000 * sizeof(uint32_t);
 					EBOsInfo[i].size = newSize;
 				}
 				else {
-					glBufferData(GL_ELEMENT_ARRAY_BUFFER, newSize, elData.data(), EBOsInfo[i].usage);
+					backend.bufferData(EBOs[i], newSize, elData.data(), EBOsInfo[i].usage);
 					EBOsInfo[i].capacity = newSize;
 					EBOsInfo[i].size = newSize;
 				}
 
 			}
 			else {
-				glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, newSize, elData.data());
+				backend.bufferSubData(EBOs[i], 0, newSize, elData.data());
 				EBOsInfo[i].size = newSize;
 			}
 		}
@@ -142,15 +121,9 @@ public:
 
 	void defineVerBufferData(uint32_t i, const std::vector<uint32_t>& attributes, GLenum usage = GL_DYNAMIC_DRAW, uint32_t size = 1000, const std::vector<float>& vertData = {}) {
 		if (i < COUNT) {
-			bind(i);
+			voi::Backend().vertexLayout(VAOs[i], VBOs[i], EBOs[i], attributes);
 
 			uint32_t total = std::accumulate(attributes.begin(), attributes.end(), 0);
-			uint32_t sum = 0;
-			for (uint32_t i = 0; i < attributes.size(); i++) {
-				glVertexAttribPointer(i, attributes[i], GL_FLOAT, GL_FALSE, total * sizeof(float), (void*)(sum * sizeof(float)));
-				sum += attributes[i];
-
-			}
 
 			void *data;
 
@@ -174,7 +147,7 @@ public:
 				data = NULL;
 			}
 
-			glBufferData(GL_ARRAY_BUFFER, VBOsInfo[i].capacity, data, usage);
+			voi::Backend().bufferData(VBOs[i], VBOsInfo[i].capacity, data, usage);
 
 
 		}
@@ -185,18 +158,18 @@ public:
 
 	void setVerBufferData(uint32_t i, const std::vector<float>& vertData, bool resize = false) {
 		if (i < COUNT) {
-			bindBuffer(i);
-
 			const size_t prevCapacity = VBOsInfo[i].capacity;
 			const size_t newSize = vertData.size() * sizeof(float);
+			voi::DrawCounters().vertexBytes += newSize;
 
 			if (resize || newSize > prevCapacity) {
-				glBufferData(GL_ARRAY_BUFFER, newSize, vertData.data(), VBOsInfo[i].usage);
+				voi::DrawCounters().bufferReallocations++;
+				voi::Backend().bufferData(VBOs[i], newSize, vertData.data(), VBOsInfo[i].usage);
 				VBOsInfo[i].capacity = newSize;
 				VBOsInfo[i].size = newSize;
 			}
 			else {
-				glBufferSubData(GL_ARRAY_BUFFER, 0, newSize, vertData.data());
+				voi::Backend().bufferSubData(VBOs[i], 0, newSize, vertData.data());
 				VBOsInfo[i].size = newSize;
 			}
 
@@ -208,13 +181,13 @@ public:
 
 	void addVerBufferData(uint32_t i, const std::vector<float>& vertData) {
 		if (i < COUNT) {
-			bindBuffer(i);
 			const size_t size = VBOsInfo[i].size;
 			const size_t capacity = VBOsInfo[i].capacity;
 
 			const size_t addedSize = vertData.size() * sizeof(float);
 			if (size + addedSize <= capacity) {
-				glBufferSubData(GL_ARRAY_BUFFER, size, addedSize, vertData.data());
+				voi::DrawCounters().vertexBytes += addedSize;
+				voi::Backend().bufferSubData(VBOs[i], size, addedSize, vertData.data());
 				VBOsInfo[i].size = size + addedSize;
 			}
 			else {
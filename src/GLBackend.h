@@ -0,0 +1,186 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <numeric>
+#include <unordered_map>
+
+#include "utilDefs.h"
+#include "RenderBackend.h"
+#include "Shader.h"
+#include "Headless.h"
+
+namespace voi {
+	/*gl 3.3 core, objects are bound to be edited*/
+	class GL33Backend : public RenderBackend {
+	public:
+		const char* getName() const override { return "gl33"; }
+
+		//---buffers---//
+
+		void createBuffers(ui32 count, ui32* buffers) override { glGenBuffers(count, buffers); }
+		void deleteBuffers(ui32 count, const ui32* buffers) override { glDeleteBuffers(count, buffers); }
+
+		// the copy target isn't part of a vertex array, so the one bound keeps its element buffer
+		void bufferData(ui32 buffer, size_t size, const void* data, GLenum usage) override {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+		}
+		void bufferSubData(ui32 buffer, size_t offset, size_t size, const void* data) override {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+		}
+		void bindUniformBuffer(ui32 binding, ui32 buffer) override { glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer); }
+
+		//---vertex layout---//
+
+		void createVertexArrays(ui32 count, ui32* arrays) override { glGenVertexArrays(count, arrays); }
+		void deleteVertexArrays(ui32 count, const ui32* arrays) override { glDeleteVertexArrays(count, arrays); }
+
+		void vertexLayout(ui32 array, ui32 vertexBuffer, ui32 elementBuffer, const std::vector<ui32>& attributes) override {
+			glBindVertexArray(array);
+			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+
+			const ui32 total = std::accumulate(attributes.begin(), attributes.end(), 0);
+			ui32 sum = 0;
+			for (ui32 i = 0; i < attributes.size(); i++) {
+				glVertexAttribPointer(i, attributes[i], GL_FLOAT, GL_FALSE, total * sizeof(float), (void*)(sum * sizeof(float)));
+				sum += attributes[i];
+			}
+		}
+		void enableAttributes(ui32 array, const std::vector<ui32>& attributes) override {
+			glBindVertexArray(array);
+			for (ui32 n : attributes) glEnableVertexAttribArray(n);
+		}
+
+		//---programs---//
+
+		ui32 createProgram(const std::string& vertexCode, const std::string& fragmentCode, ProgramKind /*kind*/) override {
+			return Shader::programLinking(vertexCode, fragmentCode);
+		}
+		bool isProgram(ui32 program) override { return glIsProgram(program) == GL_TRUE; }
+		void useProgram(ui32 program) override { glUseProgram(program); }
+
+		//---textures---//
+
+		void createTextures(ui32 count, ui32* textures) override { glGenTextures(count, textures); }
+		void deleteTextures(ui32 count, const ui32* textures) override { glDeleteTextures(count, textures); }
+
+		void textureSampling(ui32 texture, GLenum wrap, GLenum minFilter, GLenum magFilter) override {
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+		}
+		void textureImage(ui32 texture, i32 width, i32 height, GLenum format, const void* pixels, bool mipmap) override {
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+			if (mipmap) glGenerateMipmap(GL_TEXTURE_2D);
+		}
+		void bindTexture(ui32 unit, GLenum target, ui32 texture) override {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(target, texture);
+		}
+
+		//---drawing---//
+
+		void initState() override {
+			glEnable(GL_DEPTH_TEST);
+			glDepthFunc(GL_LEQUAL);
+			glClearStencil(0);
+		}
+		void viewport(i32 x, i32 y, i32 width, i32 height) override { glViewport(x, y, width, height); }
+		void clearColor(const Pixel& color) override { glClearColor(color.r, color.g, color.b, color.a); }
+		void clear(GLbitfield mask) override { glClear(mask); }
+
+		void setBlend(bool blend) override {
+			if (blend) {
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
+			else glDisable(GL_BLEND);
+		}
+		void drawElements(ui32 array, GLenum mode, ui32 count) override {
+			glBindVertexArray(array);
+			glDrawElements(mode, count, GL_UNSIGNED_INT, 0);
+		}
+		void readPixels(ui32 width, ui32 height, std::vector<ui8>& rgba) override { ReadPixels(width, height, rgba); }
+	};
+
+	/*gl 4.5 direct state access. buffers, vertex arrays and textures are edited by name, so streaming a batch
+	doesn't bind anything, and textures sent again at the same size are written into the storage they have*/
+	class GL45Backend : public GL33Backend {
+		// size each texture was last given, a different one allocates it again
+		std::unordered_map<ui32, std::pair<i32, i32>> textureSizes;
+
+	public:
+		/*false when the context loaded is older than 4.5*/
+		static bool Supported() { return GLAD_GL_VERSION_4_5 != 0; }
+
+		const char* getName() const override { return "gl45"; }
+
+		//---buffers---//
+
+		void createBuffers(ui32 count, ui32* buffers) override { glCreateBuffers(count, buffers); }
+
+		void bufferData(ui32 buffer, size_t size, const void* data, GLenum usage) override {
+			glNamedBufferData(buffer, size, data, usage);
+		}
+		void bufferSubData(ui32 buffer, size_t offset, size_t size, const void* data) override {
+			glNamedBufferSubData(buffer, offset, size, data);
+		}
+
+		//---vertex layout---//
+
+		void createVertexArrays(ui32 count, ui32* arrays) override { glCreateVertexArrays(count, arrays); }
+
+		// every attribute comes from binding 0
+		void vertexLayout(ui32 array, ui32 vertexBuffer, ui32 elementBuffer, const std::vector<ui32>& attributes) override {
+			glVertexArrayElementBuffer(array, elementBuffer);
+
+			const ui32 total = std::accumulate(attributes.begin(), attributes.end(), 0);
+			glVertexArrayVertexBuffer(array, 0, vertexBuffer, 0, total * sizeof(float));
+
+			ui32 sum = 0;
+			for (ui32 i = 0; i < attributes.size(); i++) {
+				glVertexArrayAttribFormat(array, i, attributes[i], GL_FLOAT, GL_FALSE, sum * sizeof(float));
+				glVertexArrayAttribBinding(array, i, 0);
+				sum += attributes[i];
+			}
+		}
+		void enableAttributes(ui32 array, const std::vector<ui32>& attributes) override {
+			for (ui32 n : attributes) glEnableVertexArrayAttrib(array, n);
+		}
+
+		//---textures---//
+
+		void createTextures(ui32 count, ui32* textures) override { glCreateTextures(GL_TEXTURE_2D, count, textures); }
+		void deleteTextures(ui32 count, const ui32* textures) override {
+			for (ui32 i = 0; i < count; i++) textureSizes.erase(textures[i]);
+			glDeleteTextures(count, textures);
+		}
+
+		void textureSampling(ui32 texture, GLenum wrap, GLenum minFilter, GLenum magFilter) override {
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_S, wrap);
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_T, wrap);
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, minFilter);
+			glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, magFilter);
+		}
+		void textureImage(ui32 texture, i32 width, i32 height, GLenum format, const void* pixels, bool mipmap) override {
+			auto size = textureSizes.find(texture);
+			if (size != textureSizes.end() && size->second == std::make_pair(width, height)) {
+				glTextureSubImage2D(texture, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, pixels);
+			}
+			else {
+				// there is no named call for storage that can change size later
+				GL33Backend::textureImage(texture, width, height, format, pixels, false);
+				textureSizes[texture] = { width, height };
+			}
+			if (mipmap) glGenerateTextureMipmap(texture);
+		}
+		void bindTexture(ui32 unit, GLenum /*target*/, ui32 texture) override { glBindTextureUnit(unit, texture); }
+	};
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Pixel.h"
+#include "Shader.h"
+
+namespace voi {
+	/*what an emitter spawns, the random ranges are sampled on the gpu for every new particle*/
+	struct GpuEmitterDesc {
+		Vec2f position;
+		// particles start anywhere in this circle around position
+		float radius = 0.f;
+		// direction of the starting velocity and the whole angle around it, in radians
+		float angle = 0.f;
+		float spread = 6.2831853f;
+		float speedMin = 50.f, speedMax = 100.f;
+		float lifeMin = 1.f, lifeMax = 2.f;
+		// particles per second
+		float rate = 1000.f;
+
+		Vec2f gravity;
+		float drag = 0.f;
+
+		Pixel color = { 1.f, 1.f, 1.f, 1.f };
+		Pixel endColor = { 1.f, 1.f, 1.f, 0.f };
+		float size = 1.f, endSize = 1.f;
+	};
+
+	/*particles that never leave the gpu. their state lives in two buffers, each update runs a vertex shader
+	over one and captures the result into the other with transform feedback, then they swap. new particles
+	take the oldest slots of a ring, so there is nothing to compact and no particle is read back; the cpu only
+	sets the uniforms of the emitter every frame.
+	update only queues the step, the queued steps run right before drawing*/
+	class GpuParticleEmitter {
+	public:
+		/*uniforms of one queued update*/
+		struct Step {
+			float dt;
+			ui32 spawnStart;
+			ui32 spawnCount;
+			ui32 seed;
+			GpuEmitterDesc desc;
+		};
+
+		/*steps queued since the previous capture and what the draw needs, for drawing on another thread*/
+		struct Data {
+			std::vector<Step> steps;
+			GpuEmitterDesc desc;
+			float z = 0.f;
+		};
+
+	private:
+		ui32 vbo[2] = { 0, 0 };
+		// update reads position, velocity and life, drawing reads position and life per instance
+		ui32 updateVao[2] = { 0, 0 };
+		ui32 drawVao[2] = { 0, 0 };
+		ui32 current = 0;
+
+		ui32 capacity;
+		Shader updateProgram;
+		Shader drawProgram;
+
+		GpuEmitterDesc desc;
+		std::vector<Step> pending;
+		bool emitting = true;
+		float spawnDebt = 0.f;
+		ui32 cursor = 0;
+		ui32 seed = 0;
+		float z = 0.f;
+
+	public:
+		// x, y, vx, vy, remaining life, total life
+		static constexpr ui32 STATE_FLOATS = 6;
+
+		/*output names of the update shader, in the order they are stored*/
+		static const char* const* Varyings(ui32& count) {
+			static const char* const varyings[3] = { "oPos", "oVel", "oLife" };
+			count = 3;
+			return varyings;
+		}
+
+		GpuParticleEmitter(ui32 _capacity, ui32 updateProgramId, ui32 drawProgramId) :
+			capacity(_capacity > 0 ? _capacity : 1), updateProgram(updateProgramId), drawProgram(drawProgramId) {
+
+			// every slot starts dead
+			const std::vector<float> state((size_t)capacity * STATE_FLOATS, 0.f);
+			const GLsizei stride = STATE_FLOATS * sizeof(float);
+
+			glGenBuffers(2, vbo);
+			glGenVertexArrays(2, updateVao);
+			glGenVertexArrays(2, drawVao);
+
+			for (ui32 i = 0; i < 2; i++) {
+				glBindVertexArray(updateVao[i]);
+				glBindBuffer(GL_ARRAY_BUFFER, vbo[i]);
+				glBufferData(GL_ARRAY_BUFFER, state.size() * sizeof(float), state.data(), GL_DYNAMIC_COPY);
+
+				glEnableVertexAttribArray(0);
+				glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+				glEnableVertexAttribArray(1);
+				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+				glEnableVertexAttribArray(2);
+				glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+
+				glBindVertexArray(drawVao[i]);
+				glEnableVertexAttribArray(0);
+				glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+				glVertexAttribDivisor(0, 1);
+				glEnableVertexAttribArray(1);
+				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+				glVertexAttribDivisor(1, 1);
+			}
+
+			glBindVertexArray(0);
+		}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			if (vbo[0] != 0) glDeleteBuffers(2, vbo);
+			if (updateVao[0] != 0) glDeleteVertexArrays(2, updateVao);
+			if (drawVao[0] != 0) glDeleteVertexArrays(2, drawVao);
+			vbo[0] = vbo[1] = updateVao[0] = updateVao[1] = drawVao[0] = drawVao[1] = 0;
+		}
+
+		ui32 getCapacity() const { return capacity; }
+
+		GpuEmitterDesc& getDesc() { return desc; }
+		void setDesc(const GpuEmitterDesc& _desc) { desc = _desc; }
+
+		/*stopping lets the living particles run out*/
+		void setEmitting(bool _emitting) { emitting = _emitting; }
+		void setZ(float _z) { z = _z; }
+
+		/*steps queued by update that haven't run yet*/
+		const std::vector<Step>& getPending() const { return pending; }
+
+		/*spawns count particles on the next update, on top of the rate*/
+		void burst(ui32 count) { spawnDebt += (float)count; }
+
+		void update(float dt) {
+			if (emitting) spawnDebt += desc.rate * dt;
+
+			// slots are reused oldest first, more than capacity in one step would only overwrite themselves
+			ui32 spawnCount = (ui32)spawnDebt;
+			spawnDebt -= (float)spawnCount;
+			spawnCount = spawnCount < capacity ? spawnCount : capacity;
+
+			pending.push_back({ dt, cursor, spawnCount, seed++, desc });
+			cursor = (cursor + spawnCount) % capacity;
+		}
+
+		/*runs the queued steps*/
+		void flush() {
+			for (const Step& step : pending) simulate(step);
+			pending.clear();
+		}
+
+		void capture(Data& data) {
+			data.steps.swap(pending);
+			pending.clear();
+			data.desc = desc;
+			data.z = z;
+		}
+
+		void draw() {
+			flush();
+			draw(desc, z);
+		}
+
+		void draw(const Data& data) {
+			for (const Step& step : data.steps) simulate(step);
+			draw(data.desc, data.z);
+		}
+
+		/*copy of the state of every slot, STATE_FLOATS each, after the queued steps. stalls until they are done,
+		it is meant for debugging and for checking the simulation against the cpu one*/
+		void readBack(std::vector<float>& out) {
+			flush();
+
+			out.resize((size_t)capacity * STATE_FLOATS);
+			glBindBuffer(GL_ARRAY_BUFFER, vbo[current]);
+			glGetBufferSubData(GL_ARRAY_BUFFER, 0, out.size() * sizeof(float), out.data());
+		}
+
+	private:
+		void simulate(const Step& step) {
+			const GpuEmitterDesc& d = step.desc;
+
+			updateProgram.use();
+			updateProgram.setFloat("dt", step.dt);
+			updateProgram.setFloat("damping", 1.f / (1.f + d.drag * step.dt));
+			updateProgram.setVec2("gravity", d.gravity.x, d.gravity.y);
+			updateProgram.setUInt("spawnStart", step.spawnStart);
+			updateProgram.setUInt("spawnCount", step.spawnCount);
+			updateProgram.setUInt("capacity", capacity);
+			updateProgram.setUInt("seed", step.seed);
+			updateProgram.setVec2("emitPosition", d.position.x, d.position.y);
+			updateProgram.setFloat("emitRadius", d.radius);
+			updateProgram.setVec2("emitAngle", d.angle, d.spread);
+			updateProgram.setVec2("emitSpeed", d.speedMin, d.speedMax);
+			updateProgram.setVec2("emitLife", d.lifeMin, d.lifeMax);
+
+			glEnable(GL_RASTERIZER_DISCARD);
+			glBindVertexArray(updateVao[current]);
+			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, vbo[current ^ 1]);
+
+			glBeginTransformFeedback(GL_POINTS);
+			glDrawArrays(GL_POINTS, 0, (GLsizei)capacity);
+			glEndTransformFeedback();
+			DrawCounters().countDraw(capacity);
+
+			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+			glDisable(GL_RASTERIZER_DISCARD);
+
+			current ^= 1;
+		}
+
+		/*every slot is drawn, the dead ones come out as empty quads*/
+		void draw(const GpuEmitterDesc& d, float drawZ) {
+			drawProgram.use();
+			drawProgram.setFloat("z", drawZ);
+			drawProgram.setVec4("color", d.color.r, d.color.g, d.color.b, d.color.a);
+			drawProgram.setVec4("endColor", d.endColor.r, d.endColor.g, d.endColor.b, d.endColor.a);
+			drawProgram.setVec2("size", d.size, d.endSize);
+
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+			glBindVertexArray(drawVao[current]);
+			glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)capacity);
+			DrawCounters().countDraw(4 * (ui64)capacity);
+
+			glDisable(GL_BLEND);
+		}
+	};
+}
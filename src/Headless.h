@@ -0,0 +1,186 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#ifdef VOI_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+#include "utilDefs.h"
+#include "FrameStats.h"
+
+namespace voi {
+	/*framebuffer drawn into instead of a window, RGBA8 color with the same depth and stencil a window gets*/
+	class OffscreenTarget {
+		ui32 fbo = 0;
+		ui32 color = 0;
+		ui32 depthStencil = 0;
+		ui32 width = 0, height = 0;
+
+	public:
+		bool create(ui32 _width, ui32 _height) {
+			width = _width;
+			height = _height;
+
+			glGenFramebuffers(1, &fbo);
+			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+			glGenRenderbuffers(1, &color);
+			glBindRenderbuffer(GL_RENDERBUFFER, color);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+			glGenRenderbuffers(1, &depthStencil);
+			glBindRenderbuffer(GL_RENDERBUFFER, depthStencil);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+				std::cout << "ERROR::OFFSCREEN::FRAMEBUFFER_INCOMPLETE" << std::endl;
+				release();
+				return false;
+			}
+			return true;
+		}
+
+		bool isCreated() const { return fbo != 0; }
+		ui32 getWidth() const { return width; }
+		ui32 getHeight() const { return height; }
+
+		/*every draw goes to it until another framebuffer is bound*/
+		void bind() const { glBindFramebuffer(GL_FRAMEBUFFER, fbo); }
+
+		void release() {
+			if (fbo != 0) glDeleteFramebuffers(1, &fbo);
+			if (color != 0) glDeleteRenderbuffers(1, &color);
+			if (depthStencil != 0) glDeleteRenderbuffers(1, &depthStencil);
+			fbo = color = depthStencil = 0;
+		}
+	};
+
+	/*copies width * height pixels of the bound framebuffer to rgba, rows from the top like image files. waits
+	for the gpu to finish everything drawn before*/
+	inline void ReadPixels(ui32 width, ui32 height, std::vector<ui8>& rgba) {
+		const size_t row = (size_t)width * 4;
+		rgba.resize(row * height);
+
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+		// gl gives the bottom row first
+		std::vector<ui8> swap(row);
+		for (ui32 y = 0; y < height / 2; y++) {
+			ui8* top = rgba.data() + y * row;
+			ui8* bottom = rgba.data() + (height - 1 - y) * row;
+			memcpy(swap.data(), top, row);
+			memcpy(top, bottom, row);
+			memcpy(bottom, swap.data(), row);
+		}
+
+		DrawCounters().otherBytes += row * height;
+	}
+
+#ifdef VOI_EGL
+	/*gl 3.3 core context with no window or display server. mesa's surfaceless platform is tried first, it
+	works with llvmpipe and no gpu, then the default display with a 1x1 pbuffer. nothing is presented, so
+	frames have to go to an OffscreenTarget*/
+	class HeadlessContext {
+		EGLDisplay display = EGL_NO_DISPLAY;
+		EGLSurface surface = EGL_NO_SURFACE;
+		EGLContext context = EGL_NO_CONTEXT;
+
+	public:
+		bool create() {
+			auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			if (getPlatformDisplay != NULL) {
+				display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+				if (display != EGL_NO_DISPLAY && !eglInitialize(display, NULL, NULL)) display = EGL_NO_DISPLAY;
+			}
+
+			bool surfaceless = display != EGL_NO_DISPLAY;
+			if (!surfaceless) {
+				display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+				if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+					std::cout << "ERROR::EGL::NO_DISPLAY" << std::endl;
+					display = EGL_NO_DISPLAY;
+					return false;
+				}
+			}
+
+			if (!eglBindAPI(EGL_OPENGL_API)) {
+				std::cout << "ERROR::EGL::NO_OPENGL_API" << std::endl;
+				release();
+				return false;
+			}
+
+			const EGLint configAttributes[] = {
+				EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+				EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+				EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+				EGL_NONE
+			};
+			EGLConfig config;
+			EGLint configCount = 0;
+			if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+				std::cout << "ERROR::EGL::NO_CONFIG" << std::endl;
+				release();
+				return false;
+			}
+
+			const EGLint contextAttributes[] = {
+				EGL_CONTEXT_MAJOR_VERSION, 3,
+				EGL_CONTEXT_MINOR_VERSION, 3,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+			context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+			if (context == EGL_NO_CONTEXT) {
+				std::cout << "ERROR::EGL::CONTEXT_NOT_CREATED" << std::endl;
+				release();
+				return false;
+			}
+
+			// surfaceless contexts are made current without a surface, others need one even if it isn't drawn to
+			if (!surfaceless) {
+				const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+				surface = eglCreatePbufferSurface(display, config, pbufferAttributes);
+			}
+
+			if (!makeCurrent(true)) {
+				std::cout << "ERROR::EGL::CONTEXT_NOT_CURRENT" << std::endl;
+				release();
+				return false;
+			}
+			return true;
+		}
+
+		bool isCreated() const { return context != EGL_NO_CONTEXT; }
+
+		/*on the calling thread, false takes it off so another thread can make it current*/
+		bool makeCurrent(bool current) {
+			if (current) return eglMakeCurrent(display, surface, surface, context) == EGL_TRUE;
+			return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) == EGL_TRUE;
+		}
+
+		static GLADloadproc Loader() { return (GLADloadproc)eglGetProcAddress; }
+
+		void release() {
+			if (display == EGL_NO_DISPLAY) return;
+
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+			if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+			eglTerminate(display);
+
+			display = EGL_NO_DISPLAY;
+			surface = EGL_NO_SURFACE;
+			context = EGL_NO_CONTEXT;
+		}
+	};
+#endif
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+#include "utilDefs.h"
+
+namespace voi {
+	/*jobs still running in a group. waiting on it runs queued jobs instead of sleeping*/
+	class JobCounter {
+		std::atomic<ui32> pending{ 0 };
+		friend class JobSystem;
+
+	public:
+		bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	/*jobs with dependencies between them, run as a whole by JobSystem::run. a graph can be run again once it
+	finished, every job starts waiting for all of its dependencies again*/
+	class TaskGraph {
+		struct Node {
+			std::function<void()> work;
+			std::vector<ui32> successors;
+			ui32 dependencies = 0;
+		};
+
+		std::vector<Node> nodes;
+		std::unique_ptr<std::atomic<ui32>[]> remaining;
+		size_t remainingSize = 0;
+		friend class JobSystem;
+
+	public:
+		ui32 add(std::function<void()> work) {
+			nodes.push_back({ std::move(work), {}, 0 });
+			return (ui32)nodes.size() - 1;
+		}
+
+		/*after starts only once before is done*/
+		void precede(ui32 before, ui32 after) {
+			if (before >= nodes.size() || after >= nodes.size()) {
+				throw "Outside of range Exception";
+			}
+			nodes[before].successors.push_back(after);
+			nodes[after].dependencies++;
+		}
+
+		size_t size() const { return nodes.size(); }
+
+		void clear() { nodes.clear(); }
+	};
+
+	/*pool of worker threads, each with its own queue of jobs. a worker takes the newest job of its own queue and
+	steals the oldest of another one when it runs dry, so big splits spread out and small ones stay warm in the
+	cache of the thread that made them. threads waiting for jobs run queued ones meanwhile, so nested waits
+	can't lock the pool*/
+	class JobSystem {
+		struct Job {
+			std::function<void()> work;
+			JobCounter* counter;
+		};
+
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		// queue 0 takes the jobs of threads outside the pool, 1.. belong to the workers
+		std::unique_ptr<Queue[]> queues;
+		std::vector<std::thread> workers;
+
+		std::atomic<ui32> queued{ 0 };
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+		bool stopping = false;
+
+		JobCounter frameJobs;
+
+		struct Local {
+			const JobSystem* owner = nullptr;
+			ui32 queue = 0;
+		};
+		static Local& local() {
+			static thread_local Local l;
+			return l;
+		}
+
+	public:
+		JobSystem() {}
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		~JobSystem() { shutdown(); }
+
+		/*workerCount threads besides the calling one, -1 takes one per hardware thread but the caller's. pinned
+		workers stay on the core of their number, leaving the first one to the calling thread*/
+		void init(i32 workerCount = -1, bool pin = false) {
+			shutdown();
+
+			if (workerCount < 0) {
+				const i32 hardware = (i32)std::thread::hardware_concurrency();
+				workerCount = hardware > 1 ? hardware - 1 : 0;
+			}
+
+			queues.reset(new Queue[workerCount + 1]);
+			stopping = false;
+
+			workers.reserve(workerCount);
+			for (i32 w = 0; w < workerCount; w++) {
+				workers.emplace_back(&JobSystem::workerLoop, this, (ui32)w + 1);
+				if (pin) Pin(workers.back(), (ui32)w + 1);
+			}
+		}
+
+		/*finishes the queued jobs and joins the workers*/
+		void shutdown() {
+			if (!queues) return;
+
+			waitFrame();
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				stopping = true;
+			}
+			wake.notify_all();
+
+			for (auto& worker : workers) worker.join();
+			workers.clear();
+			queues.reset();
+		}
+
+		ui32 getWorkerCount() const { return (ui32)workers.size(); }
+
+		/*queues work counted by counter, it can be waited on with wait*/
+		void submit(std::function<void()> work, JobCounter& counter) {
+			counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+			if (workers.empty()) {
+				run({ std::move(work), &counter });
+				return;
+			}
+			push({ std::move(work), &counter });
+		}
+
+		/*queues work that has to be done by the end of the frame*/
+		void spawn(std::function<void()> work) {
+			submit(std::move(work), frameJobs);
+		}
+
+		void wait(JobCounter& counter) {
+			while (!counter.done()) {
+				if (!runOne()) std::this_thread::yield();
+			}
+		}
+
+		/*waits for every job spawned, the engine calls it after Update*/
+		void waitFrame() { wait(frameJobs); }
+
+		/*calls f(from, to) over ranges of at least grain items covering begin .. end, and returns once all of
+		them are done. the calling thread takes the first range*/
+		template<typename F>
+		void parallelFor(size_t begin, size_t end, size_t grain, F&& f) {
+			if (end <= begin) return;
+
+			grain = grain > 0 ? grain : 1;
+			const size_t count = end - begin;
+			// a few ranges per thread, so the ones that finish early can steal
+			const size_t most = (workers.size() + 1) * 4;
+
+			size_t ranges = (count + grain - 1) / grain;
+			ranges = ranges < most ? ranges : most;
+
+			if (ranges <= 1 || workers.empty()) {
+				f(begin, end);
+				return;
+			}
+
+			JobCounter counter;
+			for (size_t r = 1; r < ranges; r++) {
+				const size_t from = begin + count * r / ranges, to = begin + count * (r + 1) / ranges;
+				submit([&f, from, to]() { f(from, to); }, counter);
+			}
+			f(begin, begin + count / ranges);
+
+			wait(counter);
+		}
+
+		/*runs every job of graph once its dependencies are done, and returns when all of them are*/
+		void run(TaskGraph& graph) {
+			const size_t n = graph.nodes.size();
+			if (n == 0) return;
+
+			if (graph.remainingSize < n) {
+				graph.remaining.reset(new std::atomic<ui32>[n]);
+				graph.remainingSize = n;
+			}
+			for (size_t i = 0; i < n; i++) graph.remaining[i].store(graph.nodes[i].dependencies, std::memory_order_relaxed);
+
+			JobCounter counter;
+			for (size_t i = 0; i < n; i++) {
+				if (graph.nodes[i].dependencies == 0) submitNode(graph, (ui32)i, counter);
+			}
+
+			wait(counter);
+		}
+
+	private:
+		void submitNode(TaskGraph& graph, ui32 node, JobCounter& counter) {
+			submit([this, &graph, node, &counter]() {
+				graph.nodes[node].work();
+
+				for (ui32 next : graph.nodes[node].successors) {
+					if (graph.remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) submitNode(graph, next, counter);
+				}
+			}, counter);
+		}
+
+		void push(Job job) {
+			const Local& l = local();
+			Queue& queue = queues[l.owner == this ? l.queue : 0];
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.jobs.push_back(std::move(job));
+			}
+			queued.fetch_add(1, std::memory_order_release);
+
+			// taking the lock makes sure a worker about to sleep sees the job
+			{ std::lock_guard<std::mutex> lock(sleepMutex); }
+			wake.notify_one();
+		}
+
+		/*newest job of the own queue, or the oldest of another one*/
+		bool pop(Job& job) {
+			if (queued.load(std::memory_order_acquire) == 0) return false;
+
+			const Local& l = local();
+			const ui32 count = (ui32)workers.size() + 1;
+			const ui32 own = l.owner == this ? l.queue : 0;
+
+			for (ui32 i = 0; i < count; i++) {
+				const ui32 q = (own + i) % count;
+				Queue& queue = queues[q];
+
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (queue.jobs.empty()) continue;
+
+				if (q == own) {
+					job = std::move(queue.jobs.back());
+					queue.jobs.pop_back();
+				}
+				else {
+					job = std::move(queue.jobs.front());
+					queue.jobs.pop_front();
+				}
+				queued.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+			return false;
+		}
+
+		bool runOne() {
+			Job job;
+			if (!pop(job)) return false;
+
+			run(std::move(job));
+			return true;
+		}
+
+		void run(Job job) {
+			job.work();
+			job.counter->pending.fetch_sub(1, std::memory_order_release);
+		}
+
+		void workerLoop(ui32 queue) {
+			local() = { this, queue };
+
+			while (true) {
+				if (runOne()) continue;
+
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				wake.wait(lock, [this]() { return stopping || queued.load(std::memory_order_acquire) > 0; });
+				if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+			}
+		}
+
+		static void Pin(std::thread& thread, ui32 core) {
+			const ui32 cores = std::thread::hardware_concurrency();
+			if (cores == 0) return;
+			core %= cores;
+
+#if defined(__linux__)
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(core, &set);
+			pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &set);
+#elif defined(_WIN32)
+			SetThreadAffinityMask(thread.native_handle(), (DWORD_PTR)1 << core);
+#else
+			(void)thread;
+#endif
+		}
+	};
+}
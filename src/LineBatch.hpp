@@ -0,0 +1,169 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Pixel.h"
+#include "Shader.h"
+
+namespace voi {
+	enum class LineJoin { MITER = 0, BEVEL = 1, ROUND = 2 };
+	enum class LineCap { BUTT = 0, SQUARE = 1, ROUND = 2 };
+}
+
+/*thick lines drawn as one instanced quad per segment, the corners, joins and caps are worked out in line.vert.
+points of every polyline go one after another in a single stream, and instance i reads points i .. i + 3 of
+it as (previous, start, end, next). every polyline is padded with a ghost point on each side, ghosts only act
+as neighbours so the segments that would cross from one polyline into the next collapse*/
+class LineBatch {
+	// x, y, z, width, r, g, b, a, polyline id, style
+	static constexpr ui32 POINT_FLOATS = 10;
+	// join * 4 + cap, ghost points add 16
+	static constexpr ui32 GHOST_STYLE = 16;
+	// quad of the segment plus the bevel triangle of its end
+	static constexpr ui32 INSTANCE_VERTICES = 9;
+
+	ui32 vao = 0;
+	ui32 vbo = 0;
+	size_t capacity = 0;
+	// points in the buffer, only touched by the thread that draws
+	size_t uploadedPoints = 0;
+
+	Shader program;
+	std::vector<float> points;
+
+	ui32 polylineId = 0;
+	bool dirty = true;
+
+public:
+	/*copy of the points for drawing them on another thread, only filled when they changed since the previous
+	capture*/
+	struct Data {
+		std::vector<float> points;
+		bool changed = false;
+	};
+
+	LineBatch(const std::string& vertStr, const std::string& fragStr) : program(vertStr, fragStr) {
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &vbo);
+
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+		const GLsizei stride = POINT_FLOATS * sizeof(float);
+		// attribute location, point of the instance (0 previous .. 3 next), first float, float count
+		const ui32 layout[10][4] = {
+			{ 0, 0, 0, 2 }, { 8, 0, 8, 2 },
+			{ 1, 1, 0, 4 }, { 2, 1, 4, 4 }, { 3, 1, 8, 2 },
+			{ 4, 2, 0, 4 }, { 5, 2, 4, 4 }, { 6, 2, 8, 2 },
+			{ 7, 3, 0, 2 }, { 9, 3, 8, 2 }
+		};
+
+		for (const auto& attr : layout) {
+			glEnableVertexAttribArray(attr[0]);
+			glVertexAttribPointer(attr[0], attr[3], GL_FLOAT, GL_FALSE, stride, (void*)((attr[1] * POINT_FLOATS + attr[2]) * sizeof(float)));
+			glVertexAttribDivisor(attr[0], 1);
+		}
+
+		glBindVertexArray(0);
+	}
+
+	/*has to run while the context is still alive*/
+	void release() {
+		if (vbo != 0) glDeleteBuffers(1, &vbo);
+		if (vao != 0) glDeleteVertexArrays(1, &vao);
+		vbo = vao = 0;
+	}
+
+	void clear() {
+		points.clear();
+		polylineId = 0;
+		dirty = true;
+	}
+
+	void addPolyline(const voi::Vec2f* pts, size_t count, float width, const voi::Pixel& color, float z,
+		voi::LineJoin join, voi::LineCap cap, bool closed) {
+
+		// a closed polyline may already repeat its first point at the end
+		if (closed && count > 2 && pts[count - 1].x == pts[0].x && pts[count - 1].y == pts[0].y) count--;
+		if (count < 2) return;
+
+		const float id = (float)(polylineId++ & 0xffffff);
+		const float style = (float)((ui32)join * 4 + (ui32)cap);
+
+		points.reserve(points.size() + (count + 3) * POINT_FLOATS);
+
+		// closed polylines wrap their neighbours around, open ones repeat their ends so they get caps
+		const voi::Vec2f& first = closed ? pts[count - 1] : pts[0];
+		pushPoint(first.x, first.y, z, width, color, id, style + GHOST_STYLE);
+
+		float lastX = pts[0].x, lastY = pts[0].y;
+		pushPoint(lastX, lastY, z, width, color, id, style);
+
+		for (size_t i = 1; i < count; i++) {
+			// repeated points would make zero length segments and fake caps around them
+			if (pts[i].x == lastX && pts[i].y == lastY) continue;
+
+			lastX = pts[i].x; lastY = pts[i].y;
+			pushPoint(lastX, lastY, z, width, color, id, style);
+		}
+
+		if (closed) {
+			pushPoint(pts[0].x, pts[0].y, z, width, color, id, style);
+			pushPoint(pts[1].x, pts[1].y, z, width, color, id, style + GHOST_STYLE);
+		}
+		else {
+			pushPoint(lastX, lastY, z, width, color, id, style + GHOST_STYLE);
+		}
+
+		dirty = true;
+	}
+
+	void capture(Data& data) {
+		data.changed = dirty;
+		if (dirty) {
+			data.points = points;
+			dirty = false;
+		}
+	}
+
+	void DrawBatch() {
+		draw(points, dirty);
+		dirty = false;
+	}
+
+	void DrawBatch(const Data& data) {
+		draw(data.points, data.changed);
+	}
+
+private:
+	void draw(const std::vector<float>& pts, bool upload) {
+		if (upload) {
+			uploadedPoints = pts.size() / POINT_FLOATS;
+
+			if (uploadedPoints >= 4) {
+				// orphans the previous storage so the upload never waits on draws still using it
+				const size_t size = pts.size() * sizeof(float);
+				if (size > capacity) capacity = size;
+
+				glBindBuffer(GL_ARRAY_BUFFER, vbo);
+				glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, size, pts.data());
+				voi::DrawCounters().otherBytes += size;
+			}
+		}
+		if (uploadedPoints < 4) return;
+
+		program.use();
+		glBindVertexArray(vao);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, INSTANCE_VERTICES, (GLsizei)(uploadedPoints - 3));
+		voi::DrawCounters().countDraw(INSTANCE_VERTICES * (uploadedPoints - 3));
+	}
+
+	void pushPoint(float x, float y, float z, float width, const voi::Pixel& color, float id, float style) {
+		points.insert(points.end(), { x, y, z, width, color.r, color.g, color.b, color.a, id, style });
+	}
+};
@@ -24,6 +24,8 @@ namespace voi {
 		Vec2(const Vec2& other) : x(other.x), y(other.y) {}
 		Vec2(Vec2 &&other) : x(other.x), y(other.y) {}
 
+		inline Vec2& operator = (const Vec2& o) { x = o.x; y = o.y; return *this; }
+
 		inline T min() const { return x < y ? x : y; }
 		inline T max() const { return x > y ? x : y; }
 		inline static T dotProd(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
@@ -56,6 +58,29 @@ namespace voi {
 	typedef Vec2<float> Vec2f;
 	typedef Vec2<double> Vec2d;
 
+	/*axis aligned bounding box*/
+	template<typename T>
+	struct AABB2 {
+		Vec2<T> min;
+		Vec2<T> max;
+
+		AABB2() {}
+		AABB2(Vec2<T> _min, Vec2<T> _max) : min(_min), max(_max) {}
+
+		inline bool overlaps(const AABB2& o) const {
+			return min.x <= o.max.x && max.x >= o.min.x && min.y <= o.max.y && max.y >= o.min.y;
+		}
+		inline bool contains(const Vec2<T>& p) const {
+			return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+		}
+		inline void expand(const Vec2<T>& p) {
+			min.x = p.x < min.x ? p.x : min.x; min.y = p.y < min.y ? p.y : min.y;
+			max.x = p.x > max.x ? p.x : max.x; max.y = p.y > max.y ? p.y : max.y;
+		}
+	};
+
+	typedef AABB2<float> AABB2f;
+
 	/* simple vector3 struct */
 	template<typename T>
 	struct Vec3 {
@@ -73,6 +98,8 @@ namespace voi {
 		Vec3(const Vec3& other) : x(other.x), y(other.y), z(other.z) {}
 		Vec3(Vec3 &&other) : x(other.x), y(other.y), z(other.z) {}
 
+		inline Vec3& operator = (const Vec3& o) { x = o.x; y = o.y; z = o.z; return *this; }
+
 		inline T min() const {}
 
 		inline static T dotProd(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
@@ -127,6 +154,8 @@ namespace voi {
 		Vec4(const Vec4& other) : x(other.x), y(other.y), z(other.z), w(other.w) {}
 		Vec4(Vec4 &&other) : x(other.x), y(other.y), z(other.z), w(other.w) {}
 
+		inline Vec4& operator = (const Vec4& o) { x = o.x; y = o.y; z = o.z; w = o.w; return *this; }
+
 		inline static T dotProd3D(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
 		inline static T dotProd4D(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
 		inline static Vec4& cross3D(const Vec4& a, const Vec4& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
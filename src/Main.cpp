@@ -47,9 +47,6 @@ class Testing : public voi::VoiOGLEngine {
 
 	std::vector<ui32> textureIndices;
 
-	int framePrevIntT = 0;
-	int prevFrameCount = 0;
-
 	float prevTimeInterval = 0;
 
 	float timeInterval = 2*F_PI;
@@ -62,18 +59,9 @@ class Testing : public voi::VoiOGLEngine {
 		return a + (b - a) * t;
 	}
 
-	void setTitleToFramesInSecond() {
-		int intT = GetTotalTime();
-
-		if (intT > framePrevIntT) {
-			glfwSetWindowTitle(GetWindow(), std::to_string(GetFrameCount() - prevFrameCount).c_str());
-			framePrevIntT = intT;
-			prevFrameCount = GetFrameCount();
-		}
-	}
-
 	void Begin() override {
 		textureIndices.reserve(32);
+		ShowStatsOverlay(true);
 
 		img0.data = stbi_load("awesomeface.png", &img0.width, &img0.height, &img0.nChannels, 4);
 		img1.data = stbi_load("dimW.png", &img1.width, &img1.height, &img1.nChannels, 4);
@@ -88,7 +76,6 @@ class Testing : public voi::VoiOGLEngine {
 	}
 
 	void Update(float delta) override {
-		setTitleToFramesInSecond();
 		Clear();
 
 		if (prevTimeInterval + delta >= timeInterval) {
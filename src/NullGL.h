@@ -0,0 +1,398 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+
+#include "utilDefs.h"
+
+namespace voi {
+	struct NullGLStats {
+		ui64 calls = 0;
+		ui64 drawCalls = 0;
+		// bytes handed to buffers and textures
+		ui64 bufferBytes = 0;
+		ui64 textureBytes = 0;
+		// names given out by glGen*, glCreate* and glFenceSync
+		ui64 objects = 0;
+	};
+
+	/*gl driver that draws nothing. glad is loaded with functions that only count how often they are called and
+	the bytes they are given, so everything up to the driver runs as usual with no context, window or gl
+	library, and the cpu cost of the engine can be measured alone. queries answer like a driver that is always
+	done: shaders compile, fences are signaled and reads come back as zeros. like a context, it belongs to one
+	thread at a time*/
+	class NullGL {
+		struct Call {
+			const char* name;
+			ui64 count;
+		};
+		struct Proc {
+			const char* name;
+			void* function;
+		};
+
+		static std::deque<Call>& CallList() {
+			static std::deque<Call> calls;
+			return calls;
+		}
+
+		/*counter of one function, made the first time it is called*/
+		static ui64& Counter(const char* name) {
+			CallList().push_back({ name, 0 });
+			return CallList().back().count;
+		}
+
+		static GLuint NextName() {
+			static GLuint next = 0;
+			Stats().objects++;
+			return ++next;
+		}
+
+		static void GenNames(GLsizei n, GLuint* names) {
+			for (GLsizei i = 0; i < n; i++) names[i] = NextName();
+		}
+
+		static ui64 PixelBytes(GLsizei width, GLsizei height, GLenum format) {
+			ui64 channels = 4;
+			switch (format) {
+			case GL_RED: channels = 1; break;
+			case GL_RG: channels = 2; break;
+			case GL_RGB: case GL_BGR: channels = 3; break;
+			}
+			return (ui64)width * height * channels;
+		}
+
+		// sizes given to glTexImage2D, for glGetTexLevelParameteriv
+		static std::unordered_map<GLuint, std::pair<GLint, GLint>>& TextureSizes() {
+			static std::unordered_map<GLuint, std::pair<GLint, GLint>> sizes;
+			return sizes;
+		}
+		static GLuint& BoundTexture() {
+			static GLuint bound = 0;
+			return bound;
+		}
+
+	public:
+		static NullGLStats& Stats() {
+			static NullGLStats stats;
+			return stats;
+		}
+
+		/*calls of every function used so far, in the order they were first called*/
+		static std::vector<std::pair<std::string, ui64>> GetCalls() {
+			std::vector<std::pair<std::string, ui64>> calls;
+			for (const Call& call : CallList()) calls.push_back({ call.name, call.count });
+			return calls;
+		}
+
+		static void Reset() {
+			Stats() = NullGLStats();
+			for (Call& call : CallList()) call.count = 0;
+		}
+
+		/*for gladLoadGLLoader, functions the engine doesn't use are left NULL*/
+		static GLADloadproc Loader() { return &GetProc; }
+
+	private:
+		static void* GetProc(const char* name) {
+			for (const Proc& proc : Procs()) {
+				if (strcmp(proc.name, name) == 0) return proc.function;
+			}
+			return NULL;
+		}
+
+#define VOI_NULL_GL_CALL(name) static ui64& calls = Counter(name); calls++; Stats().calls++
+
+		//---state---//
+
+		static void APIENTRY ActiveTexture(GLenum) { VOI_NULL_GL_CALL("glActiveTexture"); }
+		static void APIENTRY BlendFunc(GLenum, GLenum) { VOI_NULL_GL_CALL("glBlendFunc"); }
+		static void APIENTRY Clear(GLbitfield) { VOI_NULL_GL_CALL("glClear"); }
+		static void APIENTRY ClearColor(GLfloat, GLfloat, GLfloat, GLfloat) { VOI_NULL_GL_CALL("glClearColor"); }
+		static void APIENTRY ClearStencil(GLint) { VOI_NULL_GL_CALL("glClearStencil"); }
+		static void APIENTRY ColorMask(GLboolean, GLboolean, GLboolean, GLboolean) { VOI_NULL_GL_CALL("glColorMask"); }
+		static void APIENTRY DepthFunc(GLenum) { VOI_NULL_GL_CALL("glDepthFunc"); }
+		static void APIENTRY DepthMask(GLboolean) { VOI_NULL_GL_CALL("glDepthMask"); }
+		static void APIENTRY Disable(GLenum) { VOI_NULL_GL_CALL("glDisable"); }
+		static void APIENTRY Enable(GLenum) { VOI_NULL_GL_CALL("glEnable"); }
+		static void APIENTRY PixelStorei(GLenum, GLint) { VOI_NULL_GL_CALL("glPixelStorei"); }
+		static void APIENTRY StencilFunc(GLenum, GLint, GLuint) { VOI_NULL_GL_CALL("glStencilFunc"); }
+		static void APIENTRY StencilOp(GLenum, GLenum, GLenum) { VOI_NULL_GL_CALL("glStencilOp"); }
+		static void APIENTRY StencilOpSeparate(GLenum, GLenum, GLenum, GLenum) { VOI_NULL_GL_CALL("glStencilOpSeparate"); }
+		static void APIENTRY Viewport(GLint, GLint, GLsizei, GLsizei) { VOI_NULL_GL_CALL("glViewport"); }
+		static void APIENTRY Flush() { VOI_NULL_GL_CALL("glFlush"); }
+		static void APIENTRY Finish() { VOI_NULL_GL_CALL("glFinish"); }
+		static GLenum APIENTRY GetError() { VOI_NULL_GL_CALL("glGetError"); return GL_NO_ERROR; }
+
+		static const GLubyte* APIENTRY GetString(GLenum name) {
+			VOI_NULL_GL_CALL("glGetString");
+			switch (name) {
+			case GL_VERSION: return (const GLubyte*)"3.3 null";
+			case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"3.30 null";
+			case GL_RENDERER: return (const GLubyte*)"null";
+			case GL_VENDOR: return (const GLubyte*)"voi";
+			}
+			return (const GLubyte*)"";
+		}
+		// glad fails to load with no extensions at all, so there is one
+		static const GLubyte* APIENTRY GetStringi(GLenum, GLuint) { VOI_NULL_GL_CALL("glGetStringi"); return (const GLubyte*)"GL_VOI_null"; }
+		static void APIENTRY GetIntegerv(GLenum name, GLint* data) { VOI_NULL_GL_CALL("glGetIntegerv"); *data = name == GL_NUM_EXTENSIONS ? 1 : 0; }
+		static void APIENTRY GetInteger64v(GLenum, GLint64* data) { VOI_NULL_GL_CALL("glGetInteger64v"); *data = 0; }
+
+		//---buffers and vertex arrays---//
+
+		static void APIENTRY GenBuffers(GLsizei n, GLuint* names) { VOI_NULL_GL_CALL("glGenBuffers"); GenNames(n, names); }
+		static void APIENTRY DeleteBuffers(GLsizei, const GLuint*) { VOI_NULL_GL_CALL("glDeleteBuffers"); }
+		static void APIENTRY BindBuffer(GLenum, GLuint) { VOI_NULL_GL_CALL("glBindBuffer"); }
+		static void APIENTRY BindBufferBase(GLenum, GLuint, GLuint) { VOI_NULL_GL_CALL("glBindBufferBase"); }
+		static void APIENTRY BufferData(GLenum, GLsizeiptr size, const void* data, GLenum) {
+			VOI_NULL_GL_CALL("glBufferData");
+			if (data != NULL) Stats().bufferBytes += size;
+		}
+		static void APIENTRY BufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*) {
+			VOI_NULL_GL_CALL("glBufferSubData");
+			Stats().bufferBytes += size;
+		}
+		static void APIENTRY GetBufferSubData(GLenum, GLintptr, GLsizeiptr size, void* data) {
+			VOI_NULL_GL_CALL("glGetBufferSubData");
+			memset(data, 0, size);
+		}
+
+		static void APIENTRY GenVertexArrays(GLsizei n, GLuint* names) { VOI_NULL_GL_CALL("glGenVertexArrays"); GenNames(n, names); }
+		static void APIENTRY DeleteVertexArrays(GLsizei, const GLuint*) { VOI_NULL_GL_CALL("glDeleteVertexArrays"); }
+		static void APIENTRY BindVertexArray(GLuint) { VOI_NULL_GL_CALL("glBindVertexArray"); }
+		static void APIENTRY EnableVertexAttribArray(GLuint) { VOI_NULL_GL_CALL("glEnableVertexAttribArray"); }
+		static void APIENTRY VertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) { VOI_NULL_GL_CALL("glVertexAttribPointer"); }
+		static void APIENTRY VertexAttribIPointer(GLuint, GLint, GLenum, GLsizei, const void*) { VOI_NULL_GL_CALL("glVertexAttribIPointer"); }
+		static void APIENTRY VertexAttribDivisor(GLuint, GLuint) { VOI_NULL_GL_CALL("glVertexAttribDivisor"); }
+
+		//---draws---//
+
+		static void APIENTRY DrawArrays(GLenum, GLint, GLsizei) { VOI_NULL_GL_CALL("glDrawArrays"); Stats().drawCalls++; }
+		static void APIENTRY DrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei) { VOI_NULL_GL_CALL("glDrawArraysInstanced"); Stats().drawCalls++; }
+		static void APIENTRY DrawElements(GLenum, GLsizei, GLenum, const void*) { VOI_NULL_GL_CALL("glDrawElements"); Stats().drawCalls++; }
+		static void APIENTRY DrawElementsInstanced(GLenum, GLsizei, GLenum, const void*, GLsizei) { VOI_NULL_GL_CALL("glDrawElementsInstanced"); Stats().drawCalls++; }
+		static void APIENTRY BeginTransformFeedback(GLenum) { VOI_NULL_GL_CALL("glBeginTransformFeedback"); }
+		static void APIENTRY EndTransformFeedback() { VOI_NULL_GL_CALL("glEndTransformFeedback"); }
+
+		//---textures---//
+
+		static void APIENTRY GenTextures(GLsizei n, GLuint* names) { VOI_NULL_GL_CALL("glGenTextures"); GenNames(n, names); }
+		static void APIENTRY DeleteTextures(GLsizei, const GLuint*) { VOI_NULL_GL_CALL("glDeleteTextures"); }
+		static void APIENTRY BindTexture(GLenum, GLuint texture) { VOI_NULL_GL_CALL("glBindTexture"); BoundTexture() = texture; }
+		static void APIENTRY TexParameteri(GLenum, GLenum, GLint) { VOI_NULL_GL_CALL("glTexParameteri"); }
+		static void APIENTRY TexImage2D(GLenum, GLint level, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum, const void* pixels) {
+			VOI_NULL_GL_CALL("glTexImage2D");
+			if (pixels != NULL) Stats().textureBytes += PixelBytes(width, height, format);
+			if (level == 0) TextureSizes()[BoundTexture()] = { width, height };
+		}
+		static void APIENTRY TexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum, const void*) {
+			VOI_NULL_GL_CALL("glTexSubImage2D");
+			Stats().textureBytes += PixelBytes(width, height, format);
+		}
+		static void APIENTRY TexBuffer(GLenum, GLenum, GLuint) { VOI_NULL_GL_CALL("glTexBuffer"); }
+		static void APIENTRY GenerateMipmap(GLenum) { VOI_NULL_GL_CALL("glGenerateMipmap"); }
+		static void APIENTRY GetTexLevelParameteriv(GLenum, GLint, GLenum name, GLint* value) {
+			VOI_NULL_GL_CALL("glGetTexLevelParameteriv");
+			const auto size = TextureSizes().find(BoundTexture());
+			*value = 0;
+			if (size == TextureSizes().end()) return;
+			if (name == GL_TEXTURE_WIDTH) *value = size->second.first;
+			if (name == GL_TEXTURE_HEIGHT) *value = size->second.second;
+		}
+
+		//---framebuffers---//
+
+		static void APIENTRY GenFramebuffers(GLsizei n, GLuint* names) { VOI_NULL_GL_CALL("glGenFramebuffers"); GenNames(n, names); }
+		static void APIENTRY DeleteFramebuffers(GLsizei, const GLuint*) { VOI_NULL_GL_CALL("glDeleteFramebuffers"); }
+		static void APIENTRY BindFramebuffer(GLenum, GLuint) { VOI_NULL_GL_CALL("glBindFramebuffer"); }
+		static GLenum APIENTRY CheckFramebufferStatus(GLenum) { VOI_NULL_GL_CALL("glCheckFramebufferStatus"); return GL_FRAMEBUFFER_COMPLETE; }
+		static void APIENTRY GenRenderbuffers(GLsizei n, GLuint* names) { VOI_NULL_GL_CALL("glGenRenderbuffers"); GenNames(n, names); }
+		static void APIENTRY DeleteRenderbuffers(GLsizei, const GLuint*) { VOI_NULL_GL_CALL("glDeleteRenderbuffers"); }
+		static void APIENTRY BindRenderbuffer(GLenum, GLuint) { VOI_NULL_GL_CALL("glBindRenderbuffer"); }
+		static void APIENTRY RenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) { VOI_NULL_GL_CALL("glRenderbufferStorage"); }
+		static void APIENTRY FramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) { VOI_NULL_GL_CALL("glFramebufferRenderbuffer"); }
+		static void APIENTRY ReadPixels(GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum, void* pixels) {
+			VOI_NULL_GL_CALL("glReadPixels");
+			memset(pixels, 0, PixelBytes(width, height, format));
+		}
+
+		//---shaders and programs---//
+
+		static GLuint APIENTRY CreateShader(GLenum) { VOI_NULL_GL_CALL("glCreateShader"); return NextName(); }
+		static void APIENTRY DeleteShader(GLuint) { VOI_NULL_GL_CALL("glDeleteShader"); }
+		static void APIENTRY ShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) { VOI_NULL_GL_CALL("glShaderSource"); }
+		static void APIENTRY CompileShader(GLuint) { VOI_NULL_GL_CALL("glCompileShader"); }
+		static void APIENTRY GetShaderiv(GLuint, GLenum name, GLint* value) {
+			VOI_NULL_GL_CALL("glGetShaderiv");
+			*value = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+		}
+		static void APIENTRY GetShaderInfoLog(GLuint, GLsizei size, GLsizei* length, GLchar* log) {
+			VOI_NULL_GL_CALL("glGetShaderInfoLog");
+			if (length != NULL) *length = 0;
+			if (size > 0) log[0] = '\0';
+		}
+
+		static GLuint APIENTRY CreateProgram() { VOI_NULL_GL_CALL("glCreateProgram"); return NextName(); }
+		static void APIENTRY DeleteProgram(GLuint) { VOI_NULL_GL_CALL("glDeleteProgram"); }
+		static GLboolean APIENTRY IsProgram(GLuint program) { VOI_NULL_GL_CALL("glIsProgram"); return program != 0 ? GL_TRUE : GL_FALSE; }
+		static void APIENTRY AttachShader(GLuint, GLuint) { VOI_NULL_GL_CALL("glAttachShader"); }
+		static void APIENTRY TransformFeedbackVaryings(GLuint, GLsizei, const GLchar* const*, GLenum) { VOI_NULL_GL_CALL("glTransformFeedbackVaryings"); }
+		static void APIENTRY LinkProgram(GLuint) { VOI_NULL_GL_CALL("glLinkProgram"); }
+		static void APIENTRY UseProgram(GLuint) { VOI_NULL_GL_CALL("glUseProgram"); }
+		static void APIENTRY GetProgramiv(GLuint, GLenum name, GLint* value) {
+			VOI_NULL_GL_CALL("glGetProgramiv");
+			*value = name == GL_LINK_STATUS ? GL_TRUE : 0;
+		}
+		static void APIENTRY GetProgramInfoLog(GLuint, GLsizei size, GLsizei* length, GLchar* log) {
+			VOI_NULL_GL_CALL("glGetProgramInfoLog");
+			if (length != NULL) *length = 0;
+			if (size > 0) log[0] = '\0';
+		}
+
+		static GLint APIENTRY GetUniformLocation(GLuint, const GLchar*) { VOI_NULL_GL_CALL("glGetUniformLocation"); return 0; }
+		static GLuint APIENTRY GetUniformBlockIndex(GLuint, const GLchar*) { VOI_NULL_GL_CALL("glGetUniformBlockIndex"); return 0; }
+		static void APIENTRY UniformBlockBinding(GLuint, GLuint, GLuint) { VOI_NULL_GL_CALL("glUniformBlockBinding"); }
+		static void APIENTRY Uniform1f(GLint, GLfloat) { VOI_NULL_GL_CALL("glUniform1f"); }
+		static void APIENTRY Uniform2f(GLint, GLfloat, GLfloat) { VOI_NULL_GL_CALL("glUniform2f"); }
+		static void APIENTRY Uniform3f(GLint, GLfloat, GLfloat, GLfloat) { VOI_NULL_GL_CALL("glUniform3f"); }
+		static void APIENTRY Uniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { VOI_NULL_GL_CALL("glUniform4f"); }
+		static void APIENTRY Uniform1i(GLint, GLint) { VOI_NULL_GL_CALL("glUniform1i"); }
+		static void APIENTRY Uniform1ui(GLint, GLuint) { VOI_NULL_GL_CALL("glUniform1ui"); }
+
+		//---queries and syncs---//
+
+		static void APIENTRY GenQueries(GLsizei n, GLuint* names) { VOI_NULL_GL_CALL("glGenQueries"); GenNames(n, names); }
+		static void APIENTRY DeleteQueries(GLsizei, const GLuint*) { VOI_NULL_GL_CALL("glDeleteQueries"); }
+		static void APIENTRY BeginQuery(GLenum, GLuint) { VOI_NULL_GL_CALL("glBeginQuery"); }
+		static void APIENTRY EndQuery(GLenum) { VOI_NULL_GL_CALL("glEndQuery"); }
+		static void APIENTRY QueryCounter(GLuint, GLenum) { VOI_NULL_GL_CALL("glQueryCounter"); }
+		static void APIENTRY GetQueryObjectuiv(GLuint, GLenum name, GLuint* value) {
+			VOI_NULL_GL_CALL("glGetQueryObjectuiv");
+			*value = name == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+		}
+		static void APIENTRY GetQueryObjectui64v(GLuint, GLenum, GLuint64* value) { VOI_NULL_GL_CALL("glGetQueryObjectui64v"); *value = 0; }
+
+		static GLsync APIENTRY FenceSync(GLenum, GLbitfield) { VOI_NULL_GL_CALL("glFenceSync"); return (GLsync)(uintptr_t)NextName(); }
+		static void APIENTRY DeleteSync(GLsync) { VOI_NULL_GL_CALL("glDeleteSync"); }
+		static GLenum APIENTRY ClientWaitSync(GLsync, GLbitfield, GLuint64) { VOI_NULL_GL_CALL("glClientWaitSync"); return GL_ALREADY_SIGNALED; }
+
+#undef VOI_NULL_GL_CALL
+
+		/*the casts only compile when a stub has the signature glad expects*/
+		static const std::vector<Proc>& Procs() {
+#define VOI_NULL_GL_PROC(name, type, f) { name, (void*)static_cast<type>(&f) }
+			static const std::vector<Proc> procs = {
+				VOI_NULL_GL_PROC("glActiveTexture", PFNGLACTIVETEXTUREPROC, ActiveTexture),
+				VOI_NULL_GL_PROC("glBlendFunc", PFNGLBLENDFUNCPROC, BlendFunc),
+				VOI_NULL_GL_PROC("glClear", PFNGLCLEARPROC, Clear),
+				VOI_NULL_GL_PROC("glClearColor", PFNGLCLEARCOLORPROC, ClearColor),
+				VOI_NULL_GL_PROC("glClearStencil", PFNGLCLEARSTENCILPROC, ClearStencil),
+				VOI_NULL_GL_PROC("glColorMask", PFNGLCOLORMASKPROC, ColorMask),
+				VOI_NULL_GL_PROC("glDepthFunc", PFNGLDEPTHFUNCPROC, DepthFunc),
+				VOI_NULL_GL_PROC("glDepthMask", PFNGLDEPTHMASKPROC, DepthMask),
+				VOI_NULL_GL_PROC("glDisable", PFNGLDISABLEPROC, Disable),
+				VOI_NULL_GL_PROC("glEnable", PFNGLENABLEPROC, Enable),
+				VOI_NULL_GL_PROC("glPixelStorei", PFNGLPIXELSTOREIPROC, PixelStorei),
+				VOI_NULL_GL_PROC("glStencilFunc", PFNGLSTENCILFUNCPROC, StencilFunc),
+				VOI_NULL_GL_PROC("glStencilOp", PFNGLSTENCILOPPROC, StencilOp),
+				VOI_NULL_GL_PROC("glStencilOpSeparate", PFNGLSTENCILOPSEPARATEPROC, StencilOpSeparate),
+				VOI_NULL_GL_PROC("glViewport", PFNGLVIEWPORTPROC, Viewport),
+				VOI_NULL_GL_PROC("glFlush", PFNGLFLUSHPROC, Flush),
+				VOI_NULL_GL_PROC("glFinish", PFNGLFINISHPROC, Finish),
+				VOI_NULL_GL_PROC("glGetError", PFNGLGETERRORPROC, GetError),
+				VOI_NULL_GL_PROC("glGetString", PFNGLGETSTRINGPROC, GetString),
+				VOI_NULL_GL_PROC("glGetStringi", PFNGLGETSTRINGIPROC, GetStringi),
+				VOI_NULL_GL_PROC("glGetIntegerv", PFNGLGETINTEGERVPROC, GetIntegerv),
+				VOI_NULL_GL_PROC("glGetInteger64v", PFNGLGETINTEGER64VPROC, GetInteger64v),
+
+				VOI_NULL_GL_PROC("glGenBuffers", PFNGLGENBUFFERSPROC, GenBuffers),
+				VOI_NULL_GL_PROC("glDeleteBuffers", PFNGLDELETEBUFFERSPROC, DeleteBuffers),
+				VOI_NULL_GL_PROC("glBindBuffer", PFNGLBINDBUFFERPROC, BindBuffer),
+				VOI_NULL_GL_PROC("glBindBufferBase", PFNGLBINDBUFFERBASEPROC, BindBufferBase),
+				VOI_NULL_GL_PROC("glBufferData", PFNGLBUFFERDATAPROC, BufferData),
+				VOI_NULL_GL_PROC("glBufferSubData", PFNGLBUFFERSUBDATAPROC, BufferSubData),
+				VOI_NULL_GL_PROC("glGetBufferSubData", PFNGLGETBUFFERSUBDATAPROC, GetBufferSubData),
+				VOI_NULL_GL_PROC("glGenVertexArrays", PFNGLGENVERTEXARRAYSPROC, GenVertexArrays),
+				VOI_NULL_GL_PROC("glDeleteVertexArrays", PFNGLDELETEVERTEXARRAYSPROC, DeleteVertexArrays),
+				VOI_NULL_GL_PROC("glBindVertexArray", PFNGLBINDVERTEXARRAYPROC, BindVertexArray),
+				VOI_NULL_GL_PROC("glEnableVertexAttribArray", PFNGLENABLEVERTEXATTRIBARRAYPROC, EnableVertexAttribArray),
+				VOI_NULL_GL_PROC("glVertexAttribPointer", PFNGLVERTEXATTRIBPOINTERPROC, VertexAttribPointer),
+				VOI_NULL_GL_PROC("glVertexAttribIPointer", PFNGLVERTEXATTRIBIPOINTERPROC, VertexAttribIPointer),
+				VOI_NULL_GL_PROC("glVertexAttribDivisor", PFNGLVERTEXATTRIBDIVISORPROC, VertexAttribDivisor),
+
+				VOI_NULL_GL_PROC("glDrawArrays", PFNGLDRAWARRAYSPROC, DrawArrays),
+				VOI_NULL_GL_PROC("glDrawArraysInstanced", PFNGLDRAWARRAYSINSTANCEDPROC, DrawArraysInstanced),
+				VOI_NULL_GL_PROC("glDrawElements", PFNGLDRAWELEMENTSPROC, DrawElements),
+				VOI_NULL_GL_PROC("glDrawElementsInstanced", PFNGLDRAWELEMENTSINSTANCEDPROC, DrawElementsInstanced),
+				VOI_NULL_GL_PROC("glBeginTransformFeedback", PFNGLBEGINTRANSFORMFEEDBACKPROC, BeginTransformFeedback),
+				VOI_NULL_GL_PROC("glEndTransformFeedback", PFNGLENDTRANSFORMFEEDBACKPROC, EndTransformFeedback),
+
+				VOI_NULL_GL_PROC("glGenTextures", PFNGLGENTEXTURESPROC, GenTextures),
+				VOI_NULL_GL_PROC("glDeleteTextures", PFNGLDELETETEXTURESPROC, DeleteTextures),
+				VOI_NULL_GL_PROC("glBindTexture", PFNGLBINDTEXTUREPROC, BindTexture),
+				VOI_NULL_GL_PROC("glTexParameteri", PFNGLTEXPARAMETERIPROC, TexParameteri),
+				VOI_NULL_GL_PROC("glTexImage2D", PFNGLTEXIMAGE2DPROC, TexImage2D),
+				VOI_NULL_GL_PROC("glTexSubImage2D", PFNGLTEXSUBIMAGE2DPROC, TexSubImage2D),
+				VOI_NULL_GL_PROC("glTexBuffer", PFNGLTEXBUFFERPROC, TexBuffer),
+				VOI_NULL_GL_PROC("glGenerateMipmap", PFNGLGENERATEMIPMAPPROC, GenerateMipmap),
+				VOI_NULL_GL_PROC("glGetTexLevelParameteriv", PFNGLGETTEXLEVELPARAMETERIVPROC, GetTexLevelParameteriv),
+
+				VOI_NULL_GL_PROC("glGenFramebuffers", PFNGLGENFRAMEBUFFERSPROC, GenFramebuffers),
+				VOI_NULL_GL_PROC("glDeleteFramebuffers", PFNGLDELETEFRAMEBUFFERSPROC, DeleteFramebuffers),
+				VOI_NULL_GL_PROC("glBindFramebuffer", PFNGLBINDFRAMEBUFFERPROC, BindFramebuffer),
+				VOI_NULL_GL_PROC("glCheckFramebufferStatus", PFNGLCHECKFRAMEBUFFERSTATUSPROC, CheckFramebufferStatus),
+				VOI_NULL_GL_PROC("glGenRenderbuffers", PFNGLGENRENDERBUFFERSPROC, GenRenderbuffers),
+				VOI_NULL_GL_PROC("glDeleteRenderbuffers", PFNGLDELETERENDERBUFFERSPROC, DeleteRenderbuffers),
+				VOI_NULL_GL_PROC("glBindRenderbuffer", PFNGLBINDRENDERBUFFERPROC, BindRenderbuffer),
+				VOI_NULL_GL_PROC("glRenderbufferStorage", PFNGLRENDERBUFFERSTORAGEPROC, RenderbufferStorage),
+				VOI_NULL_GL_PROC("glFramebufferRenderbuffer", PFNGLFRAMEBUFFERRENDERBUFFERPROC, FramebufferRenderbuffer),
+				VOI_NULL_GL_PROC("glReadPixels", PFNGLREADPIXELSPROC, ReadPixels),
+
+				VOI_NULL_GL_PROC("glCreateShader", PFNGLCREATESHADERPROC, CreateShader),
+				VOI_NULL_GL_PROC("glDeleteShader", PFNGLDELETESHADERPROC, DeleteShader),
+				VOI_NULL_GL_PROC("glShaderSource", PFNGLSHADERSOURCEPROC, ShaderSource),
+				VOI_NULL_GL_PROC("glCompileShader", PFNGLCOMPILESHADERPROC, CompileShader),
+				VOI_NULL_GL_PROC("glGetShaderiv", PFNGLGETSHADERIVPROC, GetShaderiv),
+				VOI_NULL_GL_PROC("glGetShaderInfoLog", PFNGLGETSHADERINFOLOGPROC, GetShaderInfoLog),
+				VOI_NULL_GL_PROC("glCreateProgram", PFNGLCREATEPROGRAMPROC, CreateProgram),
+				VOI_NULL_GL_PROC("glDeleteProgram", PFNGLDELETEPROGRAMPROC, DeleteProgram),
+				VOI_NULL_GL_PROC("glIsProgram", PFNGLISPROGRAMPROC, IsProgram),
+				VOI_NULL_GL_PROC("glAttachShader", PFNGLATTACHSHADERPROC, AttachShader),
+				VOI_NULL_GL_PROC("glTransformFeedbackVaryings", PFNGLTRANSFORMFEEDBACKVARYINGSPROC, TransformFeedbackVaryings),
+				VOI_NULL_GL_PROC("glLinkProgram", PFNGLLINKPROGRAMPROC, LinkProgram),
+				VOI_NULL_GL_PROC("glUseProgram", PFNGLUSEPROGRAMPROC, UseProgram),
+				VOI_NULL_GL_PROC("glGetProgramiv", PFNGLGETPROGRAMIVPROC, GetProgramiv),
+				VOI_NULL_GL_PROC("glGetProgramInfoLog", PFNGLGETPROGRAMINFOLOGPROC, GetProgramInfoLog),
+				VOI_NULL_GL_PROC("glGetUniformLocation", PFNGLGETUNIFORMLOCATIONPROC, GetUniformLocation),
+				VOI_NULL_GL_PROC("glGetUniformBlockIndex", PFNGLGETUNIFORMBLOCKINDEXPROC, GetUniformBlockIndex),
+				VOI_NULL_GL_PROC("glUniformBlockBinding", PFNGLUNIFORMBLOCKBINDINGPROC, UniformBlockBinding),
+				VOI_NULL_GL_PROC("glUniform1f", PFNGLUNIFORM1FPROC, Uniform1f),
+				VOI_NULL_GL_PROC("glUniform2f", PFNGLUNIFORM2FPROC, Uniform2f),
+				VOI_NULL_GL_PROC("glUniform3f", PFNGLUNIFORM3FPROC, Uniform3f),
+				VOI_NULL_GL_PROC("glUniform4f", PFNGLUNIFORM4FPROC, Uniform4f),
+				VOI_NULL_GL_PROC("glUniform1i", PFNGLUNIFORM1IPROC, Uniform1i),
+				VOI_NULL_GL_PROC("glUniform1ui", PFNGLUNIFORM1UIPROC, Uniform1ui),
+
+				VOI_NULL_GL_PROC("glGenQueries", PFNGLGENQUERIESPROC, GenQueries),
+				VOI_NULL_GL_PROC("glDeleteQueries", PFNGLDELETEQUERIESPROC, DeleteQueries),
+				VOI_NULL_GL_PROC("glBeginQuery", PFNGLBEGINQUERYPROC, BeginQuery),
+				VOI_NULL_GL_PROC("glEndQuery", PFNGLENDQUERYPROC, EndQuery),
+				VOI_NULL_GL_PROC("glQueryCounter", PFNGLQUERYCOUNTERPROC, QueryCounter),
+				VOI_NULL_GL_PROC("glGetQueryObjectuiv", PFNGLGETQUERYOBJECTUIVPROC, GetQueryObjectuiv),
+				VOI_NULL_GL_PROC("glGetQueryObjectui64v", PFNGLGETQUERYOBJECTUI64VPROC, GetQueryObjectui64v),
+				VOI_NULL_GL_PROC("glFenceSync", PFNGLFENCESYNCPROC, FenceSync),
+				VOI_NULL_GL_PROC("glDeleteSync", PFNGLDELETESYNCPROC, DeleteSync),
+				VOI_NULL_GL_PROC("glClientWaitSync", PFNGLCLIENTWAITSYNCPROC, ClientWaitSync),
+			};
+#undef VOI_NULL_GL_PROC
+			return procs;
+		}
+	};
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define VOI_PARTICLE_SSE
+#endif
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Pixel.h"
+#include "Shader.h"
+#include "JobSystem.h"
+
+namespace voi {
+	/*starting state of a particle, the color goes linearly to endColor over its life*/
+	struct ParticleDesc {
+		Vec2f position;
+		Vec2f velocity;
+		Pixel color = { 1.f, 1.f, 1.f, 1.f };
+		Pixel endColor = { 1.f, 1.f, 1.f, 0.f };
+		float life = 1.f;
+		float size = 1.f;
+	};
+
+	/*particles stored as one array per attribute and integrated four at a time. dead particles are removed
+	by moving the last one into their place, so the arrays stay packed and order is not kept. all of them
+	are drawn as one instanced quad, the buffer takes the position, size and color arrays as they are*/
+	class ParticleSystem {
+		enum Attribute { X, Y, VX, VY, R, G, B, A, DR, DG, DB, DA, LIFE, SIZE, ATTRIBUTE_COUNT };
+		// attributes sent to the gpu, in the order of their sections in the buffer
+		static constexpr ui32 DRAWN_COUNT = 7;
+
+		std::vector<float> data[ATTRIBUTE_COUNT];
+		size_t count = 0;
+
+		Vec2f gravity;
+		float drag = 0.f;
+
+		JobSystem* jobs = nullptr;
+		// below this many particles per job the update stays on the calling thread
+		size_t particlesPerJob = 32768;
+
+		ui32 vao = 0;
+		ui32 vbo = 0;
+		size_t capacity = 0;
+		Shader program;
+		float z = 0.f;
+
+	public:
+		// floats per particle given by readBack
+		static constexpr ui32 STATE_FLOATS = 6;
+
+		/*copy of what is drawn, for drawing on another thread: DRAWN_COUNT sections of count floats*/
+		struct Data {
+			std::vector<float> sections;
+			size_t count = 0;
+			float z = 0.f;
+		};
+
+		ParticleSystem(ui32 programId) : program(programId) {
+			glGenVertexArrays(1, &vao);
+			glGenBuffers(1, &vbo);
+		}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			if (vbo != 0) glDeleteBuffers(1, &vbo);
+			if (vao != 0) glDeleteVertexArrays(1, &vao);
+			vbo = vao = 0;
+		}
+
+		size_t size() const { return count; }
+
+		void setGravity(Vec2f g) { gravity = g; }
+		/*fraction of the velocity lost per second*/
+		void setDrag(float _drag) { drag = _drag; }
+		void setZ(float _z) { z = _z; }
+		/*the update is split between the jobs of the pool, nullptr keeps it on the calling thread*/
+		void setJobs(JobSystem* _jobs, size_t minPerJob = 32768) {
+			jobs = _jobs;
+			particlesPerJob = minPerJob > 0 ? minPerJob : 1;
+		}
+
+		void emit(const ParticleDesc& p) {
+			const float invLife = p.life > 0.f ? 1.f / p.life : 0.f;
+			const float values[ATTRIBUTE_COUNT] = {
+				p.position.x, p.position.y, p.velocity.x, p.velocity.y,
+				p.color.r, p.color.g, p.color.b, p.color.a,
+				(p.endColor.r - p.color.r) * invLife, (p.endColor.g - p.color.g) * invLife,
+				(p.endColor.b - p.color.b) * invLife, (p.endColor.a - p.color.a) * invLife,
+				p.life, p.size
+			};
+
+			for (ui32 a = 0; a < ATTRIBUTE_COUNT; a++) data[a].push_back(values[a]);
+			count++;
+		}
+
+		void emit(const ParticleDesc* particles, size_t n) {
+			for (ui32 a = 0; a < ATTRIBUTE_COUNT; a++) data[a].reserve(count + n);
+			for (size_t i = 0; i < n; i++) emit(particles[i]);
+		}
+
+		void clear() {
+			for (auto& attribute : data) attribute.clear();
+			count = 0;
+		}
+
+		void update(float dt) {
+			if (jobs == nullptr || count < particlesPerJob * 2) {
+				integrate(0, count, dt);
+			}
+			else {
+				// ranges on multiples of 4 so only the last one has a scalar tail
+				const size_t blocks = (count + 3) / 4;
+				jobs->parallelFor(0, blocks, particlesPerJob / 4, [this, dt](size_t from, size_t to) {
+					const size_t end = to * 4;
+					integrate(from * 4, end < count ? end : count, dt);
+				});
+			}
+
+			compact();
+		}
+
+		void draw() {
+			const float* sections[DRAWN_COUNT];
+			for (ui32 s = 0; s < DRAWN_COUNT; s++) sections[s] = data[drawn()[s]].data();
+
+			draw(sections, count, z);
+		}
+
+		void capture(Data& out) const {
+			out.count = count;
+			out.z = z;
+			out.sections.resize(DRAWN_COUNT * count);
+
+			for (ui32 s = 0; s < DRAWN_COUNT; s++) {
+				std::copy(data[drawn()[s]].begin(), data[drawn()[s]].begin() + count, out.sections.begin() + s * count);
+			}
+		}
+
+		void draw(const Data& captured) {
+			const float* sections[DRAWN_COUNT];
+			for (ui32 s = 0; s < DRAWN_COUNT; s++) sections[s] = captured.sections.data() + s * captured.count;
+
+			draw(sections, captured.count, captured.z);
+		}
+
+		/*x, y, vx, vy, remaining life and size of every particle, STATE_FLOATS each in storage order. meant for
+		checking the simulation against GpuParticleEmitter*/
+		void readBack(std::vector<float>& out) const {
+			static const Attribute attributes[STATE_FLOATS] = { X, Y, VX, VY, LIFE, SIZE };
+
+			out.resize(count * STATE_FLOATS);
+			for (size_t i = 0; i < count; i++) {
+				for (ui32 a = 0; a < STATE_FLOATS; a++) out[i * STATE_FLOATS + a] = data[attributes[a]][i];
+			}
+		}
+
+	private:
+		static const Attribute* drawn() {
+			static const Attribute attributes[DRAWN_COUNT] = { X, Y, SIZE, R, G, B, A };
+			return attributes;
+		}
+
+		void draw(const float* const* sections, size_t drawCount, float drawZ) {
+			if (drawCount == 0) return;
+
+			glBindVertexArray(vao);
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+			// one section of capacity floats per drawn attribute, pointers only move when the buffer grows
+			if (drawCount > capacity) {
+				capacity = capacity * 2 > drawCount ? capacity * 2 : drawCount;
+
+				for (ui32 s = 0; s < DRAWN_COUNT; s++) {
+					glEnableVertexAttribArray(s);
+					glVertexAttribPointer(s, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(s * capacity * sizeof(float)));
+					glVertexAttribDivisor(s, 1);
+				}
+			}
+
+			// orphans the previous storage so the upload never waits on draws still using it
+			glBufferData(GL_ARRAY_BUFFER, DRAWN_COUNT * capacity * sizeof(float), NULL, GL_STREAM_DRAW);
+			for (ui32 s = 0; s < DRAWN_COUNT; s++) {
+				glBufferSubData(GL_ARRAY_BUFFER, s * capacity * sizeof(float), drawCount * sizeof(float), sections[s]);
+			}
+			DrawCounters().otherBytes += DRAWN_COUNT * drawCount * sizeof(float);
+
+			program.use();
+			program.setFloat("z", drawZ);
+
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+			glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)drawCount);
+			DrawCounters().countDraw(4 * drawCount);
+
+			glDisable(GL_BLEND);
+		}
+
+		void integrate(size_t begin, size_t end, float dt) {
+			float* x = data[X].data(); float* y = data[Y].data();
+			float* vx = data[VX].data(); float* vy = data[VY].data();
+			float* life = data[LIFE].data();
+
+			const float damping = 1.f / (1.f + drag * dt);
+			size_t i = begin;
+
+#ifdef VOI_PARTICLE_SSE
+			const __m128 t = _mm_set1_ps(dt), damp = _mm_set1_ps(damping);
+			const __m128 gx = _mm_set1_ps(gravity.x * dt), gy = _mm_set1_ps(gravity.y * dt);
+
+			for (; i + 4 <= end; i += 4) {
+				const __m128 nvx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), gx), damp);
+				const __m128 nvy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), gy), damp);
+				_mm_storeu_ps(vx + i, nvx);
+				_mm_storeu_ps(vy + i, nvy);
+				_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(nvx, t)));
+				_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(nvy, t)));
+
+				for (ui32 c = 0; c < 4; c++) {
+					float* color = data[R + c].data() + i;
+					_mm_storeu_ps(color, _mm_add_ps(_mm_loadu_ps(color), _mm_mul_ps(_mm_loadu_ps(data[DR + c].data() + i), t)));
+				}
+
+				_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), t));
+			}
+#endif
+
+			for (; i < end; i++) {
+				vx[i] = (vx[i] + gravity.x * dt) * damping;
+				vy[i] = (vy[i] + gravity.y * dt) * damping;
+				x[i] += vx[i] * dt;
+				y[i] += vy[i] * dt;
+
+				for (ui32 c = 0; c < 4; c++) data[R + c][i] += data[DR + c][i] * dt;
+
+				life[i] -= dt;
+			}
+		}
+
+		/*swap-remove of every particle out of life*/
+		void compact() {
+			const float* life = data[LIFE].data();
+
+			size_t i = 0;
+			while (i < count) {
+				if (life[i] > 0.f) {
+					i++;
+					continue;
+				}
+
+				count--;
+				for (auto& attribute : data) attribute[i] = attribute[count];
+			}
+
+			for (auto& attribute : data) attribute.resize(count);
+		}
+	};
+}
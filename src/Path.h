@@ -0,0 +1,175 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+
+namespace voi {
+	/*winding rule deciding which parts of overlapping contours are inside*/
+	enum class FillRule { NONZERO = 0, EVENODD = 1 };
+
+	/*outline made of contours of lines and quadratic or cubic bezier curves, kept as the commands that built
+	it. curves are only turned into lines when the path is flattened, with the tolerance of the moment*/
+	class Path {
+		enum class Verb : ui8 { MOVE, LINE, QUAD, CUBIC, CLOSE };
+
+		std::vector<Verb> verbs;
+		std::vector<Vec2f> points;
+
+		// bounds of every point including the control points, curves never leave them
+		AABB2f bounds;
+
+	public:
+		Path& moveTo(Vec2f p) {
+			verbs.push_back(Verb::MOVE);
+			addPoint(p);
+			return *this;
+		}
+
+		Path& lineTo(Vec2f p) {
+			startContour();
+			verbs.push_back(Verb::LINE);
+			addPoint(p);
+			return *this;
+		}
+
+		Path& quadTo(Vec2f control, Vec2f p) {
+			startContour();
+			verbs.push_back(Verb::QUAD);
+			addPoint(control);
+			addPoint(p);
+			return *this;
+		}
+
+		Path& cubicTo(Vec2f control1, Vec2f control2, Vec2f p) {
+			startContour();
+			verbs.push_back(Verb::CUBIC);
+			addPoint(control1);
+			addPoint(control2);
+			addPoint(p);
+			return *this;
+		}
+
+		/*contours are always filled as closed, close() only ends the current one*/
+		Path& close() {
+			if (!verbs.empty() && verbs.back() != Verb::CLOSE) verbs.push_back(Verb::CLOSE);
+			return *this;
+		}
+
+		void clear() {
+			verbs.clear();
+			points.clear();
+		}
+
+		bool empty() const { return points.empty(); }
+		const AABB2f& getBounds() const { return bounds; }
+
+		/*appends the path as polygons whose chords stay within tolerance of the curves. contourStarts gets the
+		index in out of the first point of every contour*/
+		void flatten(float tolerance, std::vector<Vec2f>& out, std::vector<ui32>& contourStarts) const {
+			tolerance = tolerance > 1e-6f ? tolerance : 1e-6f;
+
+			size_t p = 0;
+			Vec2f last, start;
+			bool open = false;
+
+			for (Verb verb : verbs) {
+				if (verb == Verb::MOVE) {
+					last = start = points[p++];
+					open = false;
+					continue;
+				}
+				if (verb == Verb::CLOSE) {
+					// what follows close() starts from where the closed contour started
+					last = start;
+					open = false;
+					continue;
+				}
+
+				// contours only begin with their first line or curve, so repeated moveTo adds nothing
+				if (!open) {
+					contourStarts.push_back((ui32)out.size());
+					out.push_back(last);
+					start = last;
+					open = true;
+				}
+
+				switch (verb) {
+				case Verb::LINE:
+					last = points[p++];
+					out.push_back(last);
+					break;
+
+				case Verb::QUAD: {
+					const Vec2f c = points[p], e = points[p + 1];
+					p += 2;
+
+					// the chord of a step of 1/n in t is off the curve by at most |p0 - 2c + p1| / (4 n^2)
+					const float dx = last.x - 2.f * c.x + e.x, dy = last.y - 2.f * c.y + e.y;
+					const ui32 n = segmentsFor(sqrtf(dx * dx + dy * dy) * 0.25f, tolerance);
+
+					for (ui32 i = 1; i < n; i++) {
+						const float t = (float)i / n, u = 1.f - t;
+						out.push_back({
+							u * u * last.x + 2.f * u * t * c.x + t * t * e.x,
+							u * u * last.y + 2.f * u * t * c.y + t * t * e.y
+						});
+					}
+					last = e;
+					out.push_back(last);
+					break;
+				}
+
+				case Verb::CUBIC: {
+					const Vec2f c1 = points[p], c2 = points[p + 1], e = points[p + 2];
+					p += 3;
+
+					// same bound with the largest second difference of the control points, times 3/4
+					const float d1x = last.x - 2.f * c1.x + c2.x, d1y = last.y - 2.f * c1.y + c2.y;
+					const float d2x = c1.x - 2.f * c2.x + e.x, d2y = c1.y - 2.f * c2.y + e.y;
+					const float dd = fmaxf(d1x * d1x + d1y * d1y, d2x * d2x + d2y * d2y);
+					const ui32 n = segmentsFor(sqrtf(dd) * 0.75f, tolerance);
+
+					for (ui32 i = 1; i < n; i++) {
+						const float t = (float)i / n, u = 1.f - t;
+						const float a = u * u * u, b = 3.f * u * u * t, cc = 3.f * u * t * t, d = t * t * t;
+						out.push_back({
+							a * last.x + b * c1.x + cc * c2.x + d * e.x,
+							a * last.y + b * c1.y + cc * c2.y + d * e.y
+						});
+					}
+					last = e;
+					out.push_back(last);
+					break;
+				}
+
+				default:
+					break;
+				}
+			}
+		}
+
+	private:
+		// caps the points a single curve can turn into
+		static constexpr ui32 MAX_CURVE_SEGMENTS = 256;
+
+		static ui32 segmentsFor(float error, float tolerance) {
+			const float n = ceilf(sqrtf(error / tolerance));
+			return n < 1.f ? 1 : (n > (float)MAX_CURVE_SEGMENTS ? MAX_CURVE_SEGMENTS : (ui32)n);
+		}
+
+		void startContour() {
+			// a path that doesn't start with moveTo starts at the origin
+			if (points.empty()) moveTo({ 0.f, 0.f });
+		}
+
+		void addPoint(Vec2f p) {
+			if (points.empty()) bounds = AABB2f(p, p);
+			else bounds.expand(p);
+
+			points.push_back(p);
+		}
+	};
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <vector>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Pixel.h"
+#include "Shader.h"
+#include "Path.h"
+
+/*paths filled with stencil then cover. the flattened contours are drawn as triangles fanned from one point
+of the path into the stencil buffer only, counting windings (or flipping bits for even-odd), then the bounding
+quad of the path is drawn where the stencil isn't zero, resetting it on the way. nothing is triangulated on
+the cpu and every pixel of a path is covered once, so translucent paths blend right.
+paths in a row whose bounds don't overlap share both draws*/
+class PathBatch {
+	// x, y, z, r, g, b, a, the same layout as the solid batch so it shares its shaders
+	static constexpr ui32 VERTEX_FLOATS = 7;
+	// paths checked against each other before starting a new group
+	static constexpr ui32 MAX_GROUP = 32;
+
+	struct Entry {
+		ui32 fanStart;
+		ui32 fanCount;
+		voi::AABB2f bounds;
+		voi::FillRule rule;
+	};
+
+public:
+	/*copy of the paths for drawing them on another thread. the vertices are only filled when they changed
+	since the previous capture, the entries always are*/
+	struct Data {
+		std::vector<float> fans;
+		std::vector<float> covers;
+		std::vector<Entry> entries;
+		bool changed = false;
+	};
+
+private:
+	ui32 vao = 0;
+	ui32 vbo = 0;
+	size_t capacity = 0;
+	// stencil vertices in the buffer, the covers follow them. only touched by the thread that draws
+	size_t uploadedFanVertices = 0;
+
+	Shader program;
+
+	// stencil triangles of every path, then one cover quad per path
+	std::vector<float> fans;
+	std::vector<float> covers;
+	std::vector<Entry> entries;
+
+	std::vector<voi::Vec2f> flat;
+	std::vector<ui32> contourStarts;
+
+	bool dirty = true;
+
+public:
+	PathBatch(const std::string& vertStr, const std::string& fragStr) : program(vertStr, fragStr) {
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &vbo);
+
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+		const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+
+		glBindVertexArray(0);
+	}
+
+	/*has to run while the context is still alive*/
+	void release() {
+		if (vbo != 0) glDeleteBuffers(1, &vbo);
+		if (vao != 0) glDeleteVertexArrays(1, &vao);
+		vbo = vao = 0;
+	}
+
+	void clear() {
+		fans.clear();
+		covers.clear();
+		entries.clear();
+		dirty = true;
+	}
+
+	/*tolerance is the largest distance in world units between a curve and the lines that replace it*/
+	void addPath(const voi::Path& path, float tolerance, voi::FillRule rule, float z, const voi::Pixel& color) {
+		flat.clear();
+		contourStarts.clear();
+		path.flatten(tolerance, flat, contourStarts);
+		if (flat.size() < 3) return;
+
+		Entry entry = { (ui32)(fans.size() / VERTEX_FLOATS), 0, voi::AABB2f(flat[0], flat[0]), rule };
+
+		const voi::Vec2f anchor = flat[0];
+		for (size_t c = 0; c < contourStarts.size(); c++) {
+			const size_t start = contourStarts[c];
+			const size_t end = c + 1 < contourStarts.size() ? contourStarts[c + 1] : flat.size();
+			if (end - start < 3) continue;
+
+			// every edge including the closing one, the triangles of edges through the anchor are empty
+			for (size_t i = start; i < end; i++) {
+				const voi::Vec2f& a = flat[i];
+				const voi::Vec2f& b = flat[i + 1 < end ? i + 1 : start];
+				entry.bounds.expand(a);
+
+				pushVertex(fans, anchor.x, anchor.y, z, color);
+				pushVertex(fans, a.x, a.y, z, color);
+				pushVertex(fans, b.x, b.y, z, color);
+			}
+		}
+
+		entry.fanCount = (ui32)(fans.size() / VERTEX_FLOATS) - entry.fanStart;
+		if (entry.fanCount == 0) return;
+
+		const voi::AABB2f& box = entry.bounds;
+		pushVertex(covers, box.min.x, box.min.y, z, color);
+		pushVertex(covers, box.max.x, box.min.y, z, color);
+		pushVertex(covers, box.max.x, box.max.y, z, color);
+		pushVertex(covers, box.max.x, box.max.y, z, color);
+		pushVertex(covers, box.min.x, box.max.y, z, color);
+		pushVertex(covers, box.min.x, box.min.y, z, color);
+
+		entries.push_back(entry);
+		dirty = true;
+	}
+
+	void capture(Data& data) {
+		data.entries = entries;
+		data.changed = dirty;
+		if (dirty) {
+			data.fans = fans;
+			data.covers = covers;
+			dirty = false;
+		}
+	}
+
+	void DrawBatch() {
+		draw(fans, covers, entries, dirty);
+		dirty = false;
+	}
+
+	void DrawBatch(const Data& data) {
+		draw(data.fans, data.covers, data.entries, data.changed);
+	}
+
+private:
+	void draw(const std::vector<float>& fanData, const std::vector<float>& coverData, const std::vector<Entry>& drawn, bool upload) {
+		if (upload && !drawn.empty()) {
+			uploadedFanVertices = fanData.size() / VERTEX_FLOATS;
+
+			// orphans the previous storage so the upload never waits on draws still using it
+			const size_t fanSize = fanData.size() * sizeof(float);
+			const size_t size = fanSize + coverData.size() * sizeof(float);
+			if (size > capacity) capacity = size;
+
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, fanSize, fanData.data());
+			glBufferSubData(GL_ARRAY_BUFFER, fanSize, coverData.size() * sizeof(float), coverData.data());
+			voi::DrawCounters().vertexBytes += size;
+		}
+		if (drawn.empty()) return;
+
+		program.use();
+		glBindVertexArray(vao);
+
+		glEnable(GL_STENCIL_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		size_t first = 0;
+		while (first < drawn.size()) {
+			const size_t last = groupEnd(drawn, first);
+
+			// stencil: windings of every pixel, no color and no depth written
+			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			glDepthMask(GL_FALSE);
+			glStencilFunc(GL_ALWAYS, 0, 0xff);
+
+			if (drawn[first].rule == voi::FillRule::EVENODD) {
+				glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+			}
+			else {
+				glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+				glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+			}
+
+			const ui32 fanStart = drawn[first].fanStart;
+			const ui32 fanEnd = drawn[last - 1].fanStart + drawn[last - 1].fanCount;
+			glDrawArrays(GL_TRIANGLES, fanStart, fanEnd - fanStart);
+			voi::DrawCounters().countDraw(fanEnd - fanStart);
+
+			// cover: color where the stencil isn't zero, which also clears it for the next group
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			glDepthMask(GL_TRUE);
+			glStencilFunc(GL_NOTEQUAL, 0, 0xff);
+			glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+
+			glDrawArrays(GL_TRIANGLES, (GLint)(uploadedFanVertices + first * 6), (GLsizei)((last - first) * 6));
+			voi::DrawCounters().countDraw((last - first) * 6);
+
+			first = last;
+		}
+
+		glDisable(GL_BLEND);
+		glDisable(GL_STENCIL_TEST);
+	}
+
+	/*one past the last path of the group starting at first: same fill rule and no overlap with earlier paths
+	of the group, otherwise their windings would add up*/
+	static size_t groupEnd(const std::vector<Entry>& drawn, size_t first) {
+		size_t last = first + 1;
+		for (; last < drawn.size() && last - first < MAX_GROUP; last++) {
+			const Entry& e = drawn[last];
+			if (e.rule != drawn[first].rule) break;
+
+			bool overlaps = false;
+			for (size_t i = first; i < last && !overlaps; i++) {
+				overlaps = drawn[i].bounds.overlaps(e.bounds);
+			}
+			if (overlaps) break;
+		}
+		return last;
+	}
+
+	static void pushVertex(std::vector<float>& out, float x, float y, float z, const voi::Pixel& color) {
+		out.insert(out.end(), { x, y, z, color.r, color.g, color.b, color.a });
+	}
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+#include "utilDefs.h"
+
+namespace voi {
+	/*writes width * height RGBA8 pixels, rows from the top, as a png. the image data goes in stored deflate
+	blocks with no compression, so writing costs about as much as copying the pixels*/
+	inline bool WritePng(const std::string& path, ui32 width, ui32 height, const ui8* rgba) {
+		struct Crc {
+			static const ui32* Table() {
+				static ui32 table[256];
+				static bool made = false;
+				if (!made) {
+					for (ui32 n = 0; n < 256; n++) {
+						ui32 c = n;
+						for (ui32 k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+						table[n] = c;
+					}
+					made = true;
+				}
+				return table;
+			}
+			static ui32 Update(ui32 crc, const ui8* data, size_t size) {
+				const ui32* table = Table();
+				for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+				return crc;
+			}
+		};
+
+		auto put32 = [](std::vector<ui8>& out, ui32 v) {
+			out.push_back((ui8)(v >> 24)); out.push_back((ui8)(v >> 16)); out.push_back((ui8)(v >> 8)); out.push_back((ui8)v);
+		};
+		auto chunk = [&](std::vector<ui8>& out, const char* type, const std::vector<ui8>& data) {
+			put32(out, (ui32)data.size());
+			const size_t start = out.size();
+			out.insert(out.end(), type, type + 4);
+			out.insert(out.end(), data.begin(), data.end());
+			put32(out, Crc::Update(0xffffffffu, out.data() + start, out.size() - start) ^ 0xffffffffu);
+		};
+
+		// every row starts with filter type 0
+		const size_t rowBytes = (size_t)width * 4 + 1;
+		const size_t rawSize = rowBytes * height;
+
+		std::vector<ui8> zlib;
+		zlib.reserve(rawSize + rawSize / 65535 * 5 + 16);
+		zlib.push_back(0x78);
+		zlib.push_back(0x01);
+
+		ui32 a = 1, b = 0;
+		size_t written = 0;
+		size_t row = 0, column = 0;
+		do {
+			const size_t block = rawSize - written < 65535 ? rawSize - written : 65535;
+			zlib.push_back(written + block == rawSize ? 1 : 0);
+			zlib.push_back((ui8)block); zlib.push_back((ui8)(block >> 8));
+			zlib.push_back((ui8)~block); zlib.push_back((ui8)(~block >> 8));
+
+			for (size_t i = 0; i < block; i++) {
+				const ui8 byte = column == 0 ? 0 : rgba[row * width * 4 + column - 1];
+				if (++column == rowBytes) {
+					column = 0;
+					row++;
+				}
+
+				zlib.push_back(byte);
+				a = (a + byte) % 65521;
+				b = (b + a) % 65521;
+			}
+			written += block;
+		} while (written < rawSize);
+		put32(zlib, (b << 16) | a);
+
+		std::vector<ui8> header;
+		put32(header, width);
+		put32(header, height);
+		// 8 bits per channel, truecolor with alpha, deflate, no filter, not interlaced
+		header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+		std::vector<ui8> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+		chunk(png, "IHDR", header);
+		chunk(png, "IDAT", zlib);
+		chunk(png, "IEND", {});
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			std::cout << "ERROR::PNG::FILE_NOT_SUCCESFULLY_WRITTEN " << path << std::endl;
+			return false;
+		}
+		file.write((const char*)png.data(), png.size());
+		return true;
+	}
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+
+#include "utilDefs.h"
+
+/*scopes only exist when VOI_PROFILE is defined, otherwise the macros leave nothing behind*/
+#ifdef VOI_PROFILE
+#define VOI_PROFILE_JOIN2(a, b) a##b
+#define VOI_PROFILE_JOIN(a, b) VOI_PROFILE_JOIN2(a, b)
+// times the rest of the enclosing block on the cpu, scopes nest
+#define VOI_PROFILE_SCOPE(name) voi::ProfileScope VOI_PROFILE_JOIN(voiProfileScope, __LINE__)(name)
+// times the gl commands issued in the rest of the block on the gpu, only on the context thread and not nested
+#define VOI_PROFILE_GPU_SCOPE(name, id) voi::GpuProfileScope VOI_PROFILE_JOIN(voiGpuProfileScope, __LINE__)(name, id)
+// new frame of Update
+#define VOI_PROFILE_FRAME(frame) voi::Profiler::Get().beginFrame(frame)
+// the context thread starts drawing frame
+#define VOI_PROFILE_GPU_FRAME(frame) voi::Profiler::Get().beginGpuFrame(frame)
+#else
+#define VOI_PROFILE_SCOPE(name)
+#define VOI_PROFILE_GPU_SCOPE(name, id)
+#define VOI_PROFILE_FRAME(frame)
+#define VOI_PROFILE_GPU_FRAME(frame)
+#endif
+
+namespace voi {
+	/*collects timed scopes of a range of frames, asked for with capture. cpu scopes come from any thread.
+	gpu scopes are GL_TIME_ELAPSED queries read back once they are available, frames later, so they never
+	stall; their durations are exact but the gpu runs them some time after the cpu issues them, so they are
+	placed on their own track no earlier than the cpu issued them and one after the other*/
+	class Profiler {
+	public:
+		struct Event {
+			const char* name;
+			// -1 when there is nothing to tell apart scopes with the same name
+			i32 id;
+			// seconds since the profiler was created
+			double start;
+			double duration;
+			ui32 thread;
+			ui64 frame;
+		};
+
+		// thread id of the gpu track
+		static constexpr ui32 GPU_THREAD = 1000;
+
+	private:
+		struct GpuQuery {
+			ui32 query;
+			const char* name;
+			i32 id;
+			double issued;
+		};
+		struct GpuFrame {
+			ui64 frame;
+			std::vector<GpuQuery> queries;
+		};
+
+		const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+		std::atomic<ui64> frame{ 0 };
+		std::atomic<ui64> captureBegin{ 1 };
+		std::atomic<ui64> captureEnd{ 0 };
+
+		std::mutex eventsMutex;
+		std::vector<Event> events;
+		std::atomic<ui32> nextThread{ 0 };
+
+		// context thread only
+		std::deque<GpuFrame> gpuFrames;
+		std::vector<ui32> freeQueries;
+		bool gpuRecording = false;
+		bool gpuQueryOpen = false;
+		double gpuEnd = 0.0;
+
+		Profiler() {}
+
+	public:
+		static Profiler& Get() {
+			static Profiler profiler;
+			return profiler;
+		}
+
+		double now() const {
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+		}
+
+		/*small id of the calling thread, in the order threads first record*/
+		ui32 threadId() {
+			static thread_local ui32 id = nextThread.fetch_add(1);
+			return id;
+		}
+
+		/*records the frameCount frames after the current one, dropping what was captured before*/
+		void capture(ui32 frameCount) {
+			clear();
+			const ui64 begin = frame.load() + 1;
+			captureEnd.store(begin + frameCount);
+			captureBegin.store(begin);
+		}
+
+		/*false once the captured frames are over, gpu results of the last ones may still come in a few frames*/
+		bool capturing() const {
+			return frame.load() < captureEnd.load();
+		}
+
+		/*whether the frame the calling thread works on was captured*/
+		bool recording() const {
+			const ui64 f = currentFrame();
+			return f >= captureBegin.load(std::memory_order_relaxed) && f < captureEnd.load(std::memory_order_relaxed);
+		}
+
+		void beginFrame(ui64 _frame) {
+			frame.store(_frame);
+			ThreadFrame() = _frame;
+		}
+
+		/*frame of the calling thread, the context thread draws frames behind the one Update is on. threads
+		that never began one, the workers, take the one of Update*/
+		ui64 currentFrame() const {
+			const ui64 f = ThreadFrame();
+			return f != NO_FRAME ? f : frame.load(std::memory_order_relaxed);
+		}
+
+		void record(const char* name, i32 id, double start, double duration, ui32 thread, ui64 eventFrame) {
+			std::lock_guard<std::mutex> lock(eventsMutex);
+			events.push_back({ name, id, start, duration, thread, eventFrame });
+		}
+
+		void clear() {
+			std::lock_guard<std::mutex> lock(eventsMutex);
+			events.clear();
+		}
+
+		/*copy of everything recorded so far*/
+		std::vector<Event> getEvents() {
+			std::lock_guard<std::mutex> lock(eventsMutex);
+			return events;
+		}
+
+		//---gpu, on the context thread---//
+
+		/*reads the queries of earlier frames that are done and starts timing frame if it was captured*/
+		void beginGpuFrame(ui64 gpuFrame) {
+			ThreadFrame() = gpuFrame;
+			collect();
+
+			gpuRecording = gpuFrame >= captureBegin.load() && gpuFrame < captureEnd.load();
+			if (gpuRecording) gpuFrames.push_back({ gpuFrame, {} });
+		}
+
+		bool beginGpu(const char* name, i32 id) {
+			if (!gpuRecording || gpuQueryOpen) return false;
+
+			ui32 query;
+			if (freeQueries.empty()) glGenQueries(1, &query);
+			else {
+				query = freeQueries.back();
+				freeQueries.pop_back();
+			}
+
+			glBeginQuery(GL_TIME_ELAPSED, query);
+			gpuQueryOpen = true;
+			gpuFrames.back().queries.push_back({ query, name, id, now() });
+			return true;
+		}
+
+		void endGpu() {
+			glEndQuery(GL_TIME_ELAPSED);
+			gpuQueryOpen = false;
+		}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			for (const GpuFrame& f : gpuFrames) {
+				for (const GpuQuery& q : f.queries) freeQueries.push_back(q.query);
+			}
+			gpuFrames.clear();
+
+			if (!freeQueries.empty()) glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+			freeQueries.clear();
+		}
+
+		//---export---//
+
+		/*writes the recorded events in the trace event format of chrome://tracing and perfetto*/
+		bool writeChromeTrace(const std::string& path) {
+			std::ofstream file(path);
+			if (!file.is_open()) {
+				std::cout << "ERROR::PROFILER::FILE_NOT_SUCCESFULLY_WRITTEN " << path << std::endl;
+				return false;
+			}
+
+			const std::vector<Event> copy = getEvents();
+
+			file << "{\"traceEvents\":[\n";
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << GPU_THREAD << ",\"args\":{\"name\":\"gpu\"}}";
+			for (const Event& e : copy) {
+				file << ",\n{\"name\":\"";
+				for (const char* c = e.name; *c; c++) {
+					if (*c == '"' || *c == '\\') file << '\\';
+					file << *c;
+				}
+				file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread
+					<< ",\"ts\":" << (ui64)(e.start * 1e6) << ",\"dur\":" << (ui64)(e.duration * 1e6)
+					<< ",\"args\":{\"frame\":" << e.frame;
+				if (e.id >= 0) file << ",\"id\":" << e.id;
+				file << "}}";
+			}
+			file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+			return true;
+		}
+
+	private:
+		static constexpr ui64 NO_FRAME = ~0ull;
+
+		static ui64& ThreadFrame() {
+			static thread_local ui64 threadFrame = NO_FRAME;
+			return threadFrame;
+		}
+
+		/*frames finish in order, so reading stops at the first one with a query still pending*/
+		void collect() {
+			while (!gpuFrames.empty()) {
+				GpuFrame& f = gpuFrames.front();
+
+				if (!f.queries.empty()) {
+					GLuint available = 0;
+					glGetQueryObjectuiv(f.queries.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+					if (!available) return;
+				}
+
+				for (const GpuQuery& q : f.queries) {
+					GLuint64 elapsed = 0;
+					glGetQueryObjectui64v(q.query, GL_QUERY_RESULT, &elapsed);
+
+					const double start = q.issued > gpuEnd ? q.issued : gpuEnd;
+					const double duration = (double)elapsed * 1e-9;
+					gpuEnd = start + duration;
+
+					record(q.name, q.id, start, duration, GPU_THREAD, f.frame);
+					freeQueries.push_back(q.query);
+				}
+				gpuFrames.pop_front();
+			}
+		}
+	};
+
+	class ProfileScope {
+		const char* name;
+		double start;
+		ui64 frame;
+		bool active;
+
+	public:
+		ProfileScope(const char* _name) : name(_name) {
+			Profiler& profiler = Profiler::Get();
+			active = profiler.recording();
+			if (active) {
+				frame = profiler.currentFrame();
+				start = profiler.now();
+			}
+		}
+		~ProfileScope() {
+			if (!active) return;
+
+			Profiler& profiler = Profiler::Get();
+			profiler.record(name, -1, start, profiler.now() - start, profiler.threadId(), frame);
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	};
+
+	class GpuProfileScope {
+		bool active;
+
+	public:
+		GpuProfileScope(const char* name, i32 id = -1) {
+			active = Profiler::Get().beginGpu(name, id);
+		}
+		~GpuProfileScope() {
+			if (active) Profiler::Get().endGpu();
+		}
+
+		GpuProfileScope(const GpuProfileScope&) = delete;
+		GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+	};
+}
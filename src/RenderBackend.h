@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+#include "utilDefs.h"
+#include "Pixel.h"
+
+namespace voi {
+	enum class BackendType {
+		// bind to edit, what every gl 3.3 core context has
+		GL33,
+		// direct state access, buffers, vertex arrays and textures are edited without binding them. needs a 4.5
+		// context, GL33 is used when there isn't one
+		GL45,
+		// rasterized on the cpu by the engine, solid color and single texture batches only. needs no gl, what
+		// calls gl itself draws nothing
+		Software
+	};
+
+	/*what the fragments of a program come out as, for backends that don't run shaders. it is given where the
+	program is made, gl backends ignore it*/
+	enum class ProgramKind {
+		// anything else, the software backend draws nothing with it
+		Other,
+		// color of the vertex, default.frag
+		Solid,
+		// the texture of unit 0 mixed with the color of the vertex by its alpha, texture.frag
+		Texture
+	};
+
+	/*what GAO, RenderBatch, Shader and the engine ask of the gpu. objects are named by ids like gl names, and
+	enums are the gl ones so every backend reads them the same. tilemaps, particles, lines, paths, fonts and
+	the profiler still call gl themselves*/
+	class RenderBackend {
+	public:
+		virtual ~RenderBackend() {}
+
+		virtual const char* getName() const = 0;
+
+		//---buffers---//
+
+		virtual void createBuffers(ui32 count, ui32* buffers) = 0;
+		virtual void deleteBuffers(ui32 count, const ui32* buffers) = 0;
+		/*size bytes for buffer, filled from data when it isn't NULL. what it held before is lost*/
+		virtual void bufferData(ui32 buffer, size_t size, const void* data, GLenum usage) = 0;
+		/*size bytes at offset, inside what bufferData gave it*/
+		virtual void bufferSubData(ui32 buffer, size_t offset, size_t size, const void* data) = 0;
+		/*buffer is read by the uniform blocks bound to binding*/
+		virtual void bindUniformBuffer(ui32 binding, ui32 buffer) = 0;
+
+		//---vertex layout---//
+
+		virtual void createVertexArrays(ui32 count, ui32* arrays) = 0;
+		virtual void deleteVertexArrays(ui32 count, const ui32* arrays) = 0;
+		/*vertices of array are interleaved floats of vertexBuffer, attribute i with attributes[i] of them, and
+		its elements are read from elementBuffer*/
+		virtual void vertexLayout(ui32 array, ui32 vertexBuffer, ui32 elementBuffer, const std::vector<ui32>& attributes) = 0;
+		virtual void enableAttributes(ui32 array, const std::vector<ui32>& attributes) = 0;
+
+		//---programs---//
+
+		/*compile and link errors are printed. both shaders have to put iPos through the camera like default.vert
+		and texture.vert for a kind other than Other*/
+		virtual ui32 createProgram(const std::string& vertexCode, const std::string& fragmentCode, ProgramKind kind = ProgramKind::Other) = 0;
+		virtual bool isProgram(ui32 program) = 0;
+		virtual void useProgram(ui32 program) = 0;
+
+		//---textures---//
+
+		virtual void createTextures(ui32 count, ui32* textures) = 0;
+		virtual void deleteTextures(ui32 count, const ui32* textures) = 0;
+		virtual void textureSampling(ui32 texture, GLenum wrap, GLenum minFilter, GLenum magFilter) = 0;
+		/*width * height pixels of format, a byte per channel, stored as RGBA8*/
+		virtual void textureImage(ui32 texture, i32 width, i32 height, GLenum format, const void* pixels, bool mipmap) = 0;
+		virtual void bindTexture(ui32 unit, GLenum target, ui32 texture) = 0;
+
+		//---drawing---//
+
+		/*depth test keeping the nearest z or the last one drawn at the same z, stencil cleared to 0*/
+		virtual void initState() = 0;
+		virtual void viewport(i32 x, i32 y, i32 width, i32 height) = 0;
+		virtual void clearColor(const Pixel& color) = 0;
+		/*GL_COLOR_BUFFER_BIT, GL_DEPTH_BUFFER_BIT and GL_STENCIL_BUFFER_BIT*/
+		virtual void clear(GLbitfield mask) = 0;
+		/*src alpha, 1 - src alpha*/
+		virtual void setBlend(bool blend) = 0;
+		/*count ui32 elements of array*/
+		virtual void drawElements(ui32 array, GLenum mode, ui32 count) = 0;
+		/*everything drawn in the frame has been sent*/
+		virtual void finishFrame() {}
+		/*width * height pixels of what was drawn, rows from the top like image files*/
+		virtual void readPixels(ui32 width, ui32 height, std::vector<ui8>& rgba) = 0;
+	};
+
+	/*the backend picked at Construct, only used by the thread owning the context*/
+	inline RenderBackend*& CurrentBackend() {
+		static RenderBackend* backend = nullptr;
+		return backend;
+	}
+
+	inline RenderBackend& Backend() { return *CurrentBackend(); }
+}
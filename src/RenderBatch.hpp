@@ -1,28 +1,54 @@
 #pragma once
 #include "GAO.h"
 #include "Shader.h"
+#include "Profiler.h"
 
 class RenderBatch {
 	GAO *gao;
 	Shader program;
+	std::vector<float> vertexVec;
 	std::vector<ui32> elementVec;
 
 	ui32 vaoIndex = 0;
 	ui32 elementCount = 0;
+	// elements and vertices in the gpu buffers, only touched by the thread that draws
+	size_t uploadedElements = 0;
+	size_t uploadedVertices = 0;
+	// times the storage on the cpu had to grow, counted where vertices are added
+	ui32 growths = 0;
 
 	ui32 attribCount = 0;
+	ui32 vertexStride = 0;
 
 	std::vector<i32> textureIds	;
+	GLenum textureTarget = GL_TEXTURE_2D;
+
+	/*vertices live on the cpu until the batch is drawn, and are only sent again after they change*/
+	bool dirty = true;
+	/*retained batches keep their content through Clear() and have to be cleared explicitly*/
+	bool retained = false;
+	/*alpha blended batches, drawn with src alpha, 1 - src alpha*/
+	bool blend = false;
 
 public:
-	RenderBatch(GAO *_gao, ui32 _vaoIndex, const std::string& vertStr, const std::string&fragstr, bool path = true):
-		gao(_gao), program(vertStr, fragstr, path), vaoIndex(_vaoIndex) {}
+	/*copy of the content for drawing it on another thread, vertices and elements are only filled when they
+	changed since the previous capture*/
+	struct Data {
+		std::vector<float> vertices;
+		std::vector<ui32> elements;
+		bool changed = false;
+	};
+
+	RenderBatch(GAO *_gao, ui32 _vaoIndex, const std::string& vertStr, const std::string&fragstr, bool path = true,
+		voi::ProgramKind kind = voi::ProgramKind::Other):
+		gao(_gao), program(vertStr, fragstr, path, kind), vaoIndex(_vaoIndex) {}
 
 	RenderBatch(GAO* _gao, ui32 _vaoIndex, ui32 _programId) : gao(_gao), program(_programId), vaoIndex(_vaoIndex) {}
 
 	void defineVertBufferData(const std::vector<ui32>& attributes, GLenum usage = GL_DYNAMIC_DRAW, ui32 size = 1000, const std::vector<float>& vertData = {}) {
 		gao->defineVerBufferData(vaoIndex, attributes, usage, size, vertData);
 		attribCount = attributes.size();
+		vertexStride = std::accumulate(attributes.begin(), attributes.end(), 0);
 	}
 
 	/*(VAA) VertexAttributeArray*/
@@ -40,15 +66,48 @@ public:
 	}
 
 
+	void setRetained(bool _retained) { retained = _retained; }
+	bool isRetained() const { return retained; }
+
+	void setTextureTarget(GLenum target) { textureTarget = target; }
+
+	void setBlend(bool _blend) { blend = _blend; }
+
 	void clearBatch() {
 		gao->clearVerBufferData(vaoIndex);
+		clearVertices();
+	}
+
+	/*clears only the content on the cpu, the gpu buffers are left to the thread that draws*/
+	void clearVertices() {
+		vertexVec.clear();
 		elementVec.clear();
 
 		elementCount = 0;
+		dirty = true;
+	}
+
+	void capture(Data& data) {
+		data.changed = dirty;
+		if (dirty) {
+			data.vertices = vertexVec;
+			data.elements = elementVec;
+			dirty = false;
+		}
+	}
+
+	/*growths since the last call*/
+	ui32 takeGrowths() {
+		const ui32 g = growths;
+		growths = 0;
+		return g;
 	}
 
 	void addVertices(const std::vector<float>& vertData, const std::vector<ui32>& newElems) {
-		gao->addVerBufferData(vaoIndex, vertData);
+		const size_t vertexCapacity = vertexVec.capacity(), elementCapacity = elementVec.capacity();
+
+		vertexVec.insert(vertexVec.end(), vertData.begin(), vertData.end());
+		dirty = true;
 
 		ui32 gt = 0;
 		for (auto elem : newElems) {
@@ -59,6 +118,29 @@ public:
 			elementVec.push_back(nElem);
 		}
 		elementCount = gt + 1;
+
+		if (vertexVec.capacity() != vertexCapacity || elementVec.capacity() != elementCapacity) growths++;
+	}
+
+	/*makes room for vertCount vertices and returns where they start, the caller writes them in place.
+	elements are relative to the first of the new vertices*/
+	float* addVertices(ui32 vertCount, const ui32* newElems, size_t elemCount) {
+		const size_t vertexCapacity = vertexVec.capacity(), elementCapacity = elementVec.capacity();
+
+		const size_t start = vertexVec.size();
+		vertexVec.resize(start + (size_t)vertCount * vertexStride);
+		dirty = true;
+
+		const size_t elemStart = elementVec.size();
+		elementVec.resize(elemStart + elemCount);
+		if (vertexVec.capacity() != vertexCapacity || elementVec.capacity() != elementCapacity) growths++;
+
+		for (size_t i = 0; i < elemCount; i++) {
+			elementVec[elemStart + i] = elementCount + newElems[i];
+		}
+		elementCount += vertCount;
+
+		return vertexVec.data() + start;
 	}
 
 	i32 addTexture(ui32 id, i32 unit = -1) {
@@ -74,19 +156,46 @@ public:
 	}
 
 	void DrawBatch(GLenum mode = GL_TRIANGLES, bool redraw = false) {
+		const bool upload = !redraw && dirty;
+		if (upload) dirty = false;
+
+		draw(vertexVec, elementVec, upload, mode);
+	}
+
+	void DrawBatch(const Data& data, GLenum mode = GL_TRIANGLES) {
+		draw(data.vertices, data.elements, data.changed, mode);
+	}
+
+	void ReDrawBatch() {
+		voi::Backend().drawElements(gao->getVAO(vaoIndex), GL_TRIANGLES, uploadedElements);
+		voi::DrawCounters().countDraw(uploadedVertices, uploadedElements);
+	}
+
+private:
+	void draw(const std::vector<float>& vertices, const std::vector<ui32>& elements, bool upload, GLenum mode) {
+		VOI_PROFILE_SCOPE("DrawBatch");
+		VOI_PROFILE_GPU_SCOPE("DrawBatch", (i32)vaoIndex);
+
 		program.use();
-		if (!redraw) gao->setElBufferData(vaoIndex, elementVec, GL_DYNAMIC_DRAW);
-		else gao->bindVao(vaoIndex);
+		if (upload) {
+			VOI_PROFILE_SCOPE("batch upload");
+			gao->setVerBufferData(vaoIndex, vertices);
+			gao->setElBufferData(vaoIndex, elements, GL_DYNAMIC_DRAW);
+			uploadedElements = elements.size();
+			uploadedVertices = vertexStride > 0 ? vertices.size() / vertexStride : 0;
+		}
 
+		voi::RenderBackend& backend = voi::Backend();
 		for (int i = 0; i < textureIds.size(); i++) {
-			glActiveTexture(GL_TEXTURE0 + i);
-			glBindTexture(GL_TEXTURE_2D, textureIds[i]);
+			backend.bindTexture(i, textureTarget, textureIds[i]);
 		}
+		voi::DrawCounters().textureBinds += textureIds.size();
 
-		glDrawElements(mode, elementVec.size(), GL_UNSIGNED_INT, 0);
-	}
-	void ReDrawBatch() {
-		gao->bindVao(vaoIndex);
-		glDrawElements(GL_TRIANGLES, elementVec.size(), GL_UNSIGNED_INT, 0);
+		if (blend) backend.setBlend(true);
+
+		backend.drawElements(gao->getVAO(vaoIndex), mode, uploadedElements);
+		voi::DrawCounters().countDraw(uploadedVertices, uploadedElements);
+
+		if (blend) backend.setBlend(false);
 	}
 };
\ No newline at end of file
@@ -1,19 +1,94 @@
 #pragma once
 #include <glad/glad.h>
+// VOI_NO_GLFW builds without windows, only the null gl backend and egl headless contexts can run
+#ifndef VOI_NO_GLFW
 #include <GLFW/glfw3.h>
+#else
+struct GLFWwindow;
+#endif
 
 #include <iostream>
 #include <chrono>
 #include <vector>
 #include <string>
+#include <cstring>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <memory>
+#include <cstdio>
+
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#include "stb_image.h"
+#endif
 
 #include "utilDefs.h"
 #include "Pixel.h"
 #include "GAO.h"
 #include "Shader.h"
+#include "RenderBackend.h"
+#include "GLBackend.h"
+#include "SoftwareBackend.h"
 #include "RenderBatch.hpp"
+#include "LineBatch.hpp"
+#include "PathBatch.hpp"
+#include "Camera.h"
+#include "TransformPalette.h"
+#include "Culling.h"
+#include "SpatialGrid.h"
+#include "ShapeCache.h"
+#include "Triangulator.h"
+#include "Font.h"
+#include "Tilemap.h"
+#include "ParticleSystem.h"
+#include "GpuParticleEmitter.h"
+#include "CommandList.h"
+#include "FramePacket.h"
+#include "JobSystem.h"
+#include "FrameLimiter.h"
+#include "FrameSync.h"
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "Headless.h"
+#include "NullGL.h"
+#include "Png.h"
 
 namespace voi {
+	/*options picked at Construct*/
+	struct EngineConfig {
+		// frames Update may run ahead of drawing. 0 draws and swaps right after Update on the same thread,
+		// 1 or 2 hand every frame in a packet to a render thread that owns the context
+		ui32 renderLatency = 0;
+		// threads of the job system besides the one running Update, -1 takes one per hardware thread left
+		i32 jobWorkers = -1;
+		// keeps every worker on its own core
+		bool pinJobWorkers = false;
+
+		// seconds simulated by each FixedUpdate, 0 leaves the simulation to Update and its frame delta
+		float fixedTimestep = 0.f;
+		// steps run at most in one frame, the rest of a longer stall is dropped
+		ui32 maxFixedSteps = 5;
+		// frames per second the loop is held to, 0 doesn't limit it
+		float frameLimit = 0.f;
+		bool vsync = true;
+		// frames the gpu may be behind before the next one waits for it, 1 gives the lowest input latency and
+		// 0 leaves the queue to the driver
+		ui32 framesInFlight = 2;
+
+		// no window is shown, frames are drawn into a framebuffer of the size given to Construct. with VOI_EGL
+		// the context needs no display server, otherwise it belongs to a hidden window
+		bool headless = false;
+		// frames Update runs before the loop ends by itself, 0 runs until the window closes or Close is called
+		ui64 headlessFrames = 0;
+		// gl calls only count, see NullGL. no context or gl library is needed and nothing is drawn, for measuring
+		// the cpu side alone. implies headless
+		bool nullGL = false;
+		// what batches, textures and programs go through, see RenderBackend. falls back to GL33 when the
+		// context doesn't support the one asked for. Software implies nullGL, what calls gl itself only counts.
+		// it rasterizes with the workers of the job system
+		BackendType backend = BackendType::GL33;
+	};
+
 	struct BatchGroup {
 		ui32 index;
 		ui32 count;
@@ -58,15 +133,97 @@ namespace voi {
 
 
 	class VoiOGLEngine {
-		GLFWwindow* window;
+		GLFWwindow* window = NULL;
+		// glfw is only started for windows, the null backend and egl contexts go without it
+		bool glfwStarted = false;
+		OffscreenTarget offscreen;
+#ifdef VOI_EGL
+		HeadlessContext headlessContext;
+#endif
+		bool closeRequested = false;
+
+		RenderBackend* backend = nullptr;
+
+		// asked for during Update, then filled by the thread that draws the frame
+		bool captureRequested = false;
+		std::string capturePath;
+		std::mutex captureMutex;
+		std::vector<ui8> capturedPixels;
+		ui32 capturedWidth = 0, capturedHeight = 0;
+		bool captured = false;
+
 		Pixel clearColor = { 0.f,0.f,0.f,0.f };
 
-		GAO *mainGao;
+		EngineConfig config;
+		FrameQueue frames;
+		std::thread renderThread;
+		bool clearRequested = false;
+		std::vector<std::function<void()>> renderCommands;
+
+		JobSystem jobs;
+
+		GAO *mainGao = nullptr;
 		std::vector<RenderBatch> batches;
+		LineBatch *lineBatch = nullptr;
+		PathBatch *pathBatch = nullptr;
+
+		// the stats overlay has batches of its own, filled again every frame and drawn after everything else
+		GAO *overlayGao = nullptr;
+		std::vector<RenderBatch> overlayBatches;
+		static constexpr ui32 OVERLAY_SOLID = 0, OVERLAY_TEXT = 1;
+
+		Camera2D camera;
+		ui32 cameraUbo = 0;
+
+		TransformPalette palette;
+
+		ShapeCache shapeCache;
+		float curveTolerance = 0.25f;
+
+		TriangulationCache triangulationCache;
+		std::vector<Vec2f> polygonScratch;
+		std::vector<ui32> holeScratch;
+
+		GlyphAtlas glyphAtlas;
+		std::vector<Font*> fonts;
+		std::vector<ui32> quadElements;
+
+		ui32 tileProgram = 0;
+		std::vector<Tilemap*> tilemaps;
+
+		ui32 particleProgram = 0;
+		std::vector<ParticleSystem*> particleSystems;
+
+		ui32 gpuParticleUpdateProgram = 0;
+		ui32 gpuParticleProgram = 0;
+		std::vector<GpuParticleEmitter*> gpuEmitters;
 
-		float totalTime;
-		float loopStartT;
-		float loopEndT;
+		std::vector<CommandList*> commandLists;
+
+		bool cullingEnabled = true;
+		CullStats cullStats;
+		CullStats lastCullStats;
+		std::vector<ui32> visibleScratch;
+		std::vector<size_t> visibleCounts;
+		std::vector<ui32> visibleObjects;
+
+		double startTime = 0.0;
+		double totalTime = 0.0;
+		double loopStartT = 0.0;
+		double loopEndT = 0.0;
+
+		double stepAccumulator = 0.0;
+		float interpolation = 0.f;
+		FrameLimiter limiter;
+		FrameSync frameSync;
+
+		FrameTimes frameTimes;
+		// counters of the last frame drawn, handed over by the thread that draws
+		std::mutex statsMutex;
+		DrawStats lastDrawStats;
+		ui64 batchGrowths = 0;
+		bool statsOverlay = false;
+		i32 overlayFont = -1;
 
 		ui64 frameCount = 0;
 
@@ -81,69 +238,111 @@ namespace voi {
 		// to get the real position of a batch group, add the count of all previous batch groups
 		BatchGroup solidGroup = { 0, 1, 0, 0 };
 		BatchGroup singleTexGroup = { 1, 32, 1, 0 };
+		BatchGroup paletteGroup = { 2, 1, 33, 0 };
+		BatchGroup sdfGroup = { 3, 1, 34, 0 };
+		BatchGroup textGroup = { 4, 1, 35, 0 };
+
+		// below this many rects per job the bulk calls stay on the calling thread
+		static constexpr ui32 RECTS_PER_JOB = 4096;
 
 	public:
-		VoiOGLEngine() {
-			glfwInit();
-		}
+		VoiOGLEngine() {}
 		~VoiOGLEngine() {
+			jobs.shutdown();
+			if (cameraUbo != 0) backend->deleteBuffers(1, &cameraUbo);
+			frameSync.release();
+#ifdef VOI_PROFILE
+			Profiler::Get().release();
+#endif
+			palette.release();
+			glyphAtlas.release();
+			for (Font* font : fonts) delete font;
+			for (Tilemap* map : tilemaps) {
+				map->release();
+				delete map;
+			}
+			for (ParticleSystem* system : particleSystems) {
+				system->release();
+				delete system;
+			}
+			for (GpuParticleEmitter* emitter : gpuEmitters) {
+				emitter->release();
+				delete emitter;
+			}
+			for (CommandList* list : commandLists) delete list;
+			if (lineBatch != nullptr) {
+				lineBatch->release();
+				delete lineBatch;
+			}
+			if (pathBatch != nullptr) {
+				pathBatch->release();
+				delete pathBatch;
+			}
 			if (mainGao != nullptr) delete mainGao;
-			glfwTerminate();
+			if (overlayGao != nullptr) delete overlayGao;
+			if (backend != nullptr) {
+				if (CurrentBackend() == backend) CurrentBackend() = nullptr;
+				delete backend;
+			}
+			offscreen.release();
+#ifdef VOI_EGL
+			headlessContext.release();
+#endif
+#ifndef VOI_NO_GLFW
+			if (glfwStarted) glfwTerminate();
+#endif
 		}
 
 		void Start() {
 			First();
 			/*cleans resources alocated by glfw*/
 		}
-		bool Construct(const char* title, ui32 width, ui32 height) {
-			glfwInit();
-			/*hints at the version of openGL to use (3.3)*/
-			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-			glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-			/*hints that we want to use the core mode in openGL*/
-			glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		bool Construct(const char* title, ui32 width, ui32 height, const EngineConfig& _config = EngineConfig()) {
+			config = _config;
+			config.renderLatency = config.renderLatency > 2 ? 2 : config.renderLatency;
+			config.nullGL = config.nullGL || config.backend == BackendType::Software;
+			config.headless = config.headless || config.nullGL;
 
-			/*creates the window*/
-			window = glfwCreateWindow(width, height, title, NULL, NULL);
+			jobs.init(config.jobWorkers, config.pinJobWorkers);
 
-			if (window == NULL) {
-				std::cout << "Failed to create GLFW window" << std::endl;
-				return false;
-			}
-
-			/*makes the created window the current context in wich glfw works*/
-			glfwMakeContextCurrent(window);
-			glfwSetWindowAttrib(window, GLFW_RESIZABLE, GLFW_FALSE);
-
-			/*GLAD initialization*/
-			if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-				std::cout << "Failed to initialize GLAD" << std::endl;
-				return false;
-			}
+			startTime = FrameLimiter::Now();
+			if (!createContext(title, width, height)) return false;
+			createBackend();
 
+			if (config.headless && !offscreen.create(width, height)) return false;
 
 			/*sets opengl viewport size*/
-			glViewport(0, 0, width, height);
+			backend->viewport(0, 0, width, height);
 
-			/*sets function to callback when window is rezised*/
-			glfwSetFramebufferSizeCallback(window, viewportResize);
+			// nothing is presented headless, so there is no interval to wait for
+#ifndef VOI_NO_GLFW
+			if (!config.headless) glfwSwapInterval(config.vsync ? 1 : 0);
+#endif
+			limiter.setRate(config.frameLimit);
+			frameSync.setDepth(config.framesInFlight);
 
-			//glfwSwapInterval(0);
+			SetClearColor({ 0.2f, 0.3f, 0.3f, 1.0f });
+			backend->initState();
+			backend->clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-			glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LEQUAL);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			/*per frame camera matrix, every program reads it from the same binding point*/
+			camera.SetViewport((float)width, (float)height);
+
+			backend->createBuffers(1, &cameraUbo);
+			backend->bufferData(cameraUbo, 16 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+			backend->bindUniformBuffer(Shader::CAMERA_BLOCK_BINDING, cameraUbo);
+			uploadCamera();
 
 			mainGao = new GAO(
 				solidGroup.count +
-				singleTexGroup.count
+				singleTexGroup.count +
+				paletteGroup.count +
+				sdfGroup.count +
+				textGroup.count
 			);
-			glGenTextures(
-				singleTexGroup.count
-				, textures);
+			backend->createTextures(singleTexGroup.count, textures);
 
-			batches.emplace_back(mainGao, solidGroup.position, "default.vert", "default.frag"); //solidBatch
+			batches.emplace_back(mainGao, solidGroup.position, "default.vert", "default.frag", true, ProgramKind::Solid); //solidBatch
 			batches[solidGroup.position].defineVertBufferData({ 3,4 });
 
 			std::ifstream vertexFile("texture.vert"), fragmentFile("texture.frag");
@@ -156,13 +355,57 @@ namespace voi {
 
 			vertexFile.close(); fragmentFile.close();
 
-			const ui32 singleTexProgram = Shader::programLinking(vertexCode, fragmentCode);
+			const ui32 singleTexProgram = backend->createProgram(vertexCode, fragmentCode, ProgramKind::Texture);
+
+			// tilemaps only send position and texture coordinates, and sample like the single texture batches
+			tileProgram = loadProgram("tile.vert", "texture.frag");
+			particleProgram = loadProgram("particle.vert", "default.frag");
+			gpuParticleProgram = loadProgram("particle_gpu.vert", "default.frag");
+			{
+				std::ifstream updateFile("particle_update.vert");
+				std::stringstream updateStream;
+				updateStream << updateFile.rdbuf();
+
+				ui32 varyingCount;
+				const char* const* varyings = GpuParticleEmitter::Varyings(varyingCount);
+				gpuParticleUpdateProgram = Shader::feedbackProgramLinking(updateStream.str(), varyings, varyingCount);
+			}
 
 			for (int i = singleTexGroup.position; i < (singleTexGroup.position + singleTexGroup.count); i++) {
 				batches.emplace_back(mainGao, i, singleTexProgram); //singleTexBatches
 				batches[i].defineVertBufferData({ 3,4,2 });
 			}
 
+			palette.init();
+
+			batches.emplace_back(mainGao, paletteGroup.position, "palette.vert", "default.frag"); //paletteBatch
+			batches[paletteGroup.position].defineVertBufferData({ 3,4,1 });
+			batches[paletteGroup.position].setRetained(true);
+			batches[paletteGroup.position].setTextureTarget(GL_TEXTURE_BUFFER);
+			batches[paletteGroup.position].addTexture(palette.getTexture());
+
+			batches.emplace_back(mainGao, sdfGroup.position, "sdf.vert", "sdf.frag"); //sdfBatch
+			batches[sdfGroup.position].defineVertBufferData({ 3,4,2,4,1 });
+			batches[sdfGroup.position].setBlend(true);
+
+			glyphAtlas.init();
+
+			batches.emplace_back(mainGao, textGroup.position, "texture.vert", "text.frag"); //textBatch
+			batches[textGroup.position].defineVertBufferData({ 3,4,2 });
+			batches[textGroup.position].setBlend(true);
+			batches[textGroup.position].addTexture(glyphAtlas.getTexture());
+
+			lineBatch = new LineBatch("line.vert", "line.frag");
+			pathBatch = new PathBatch("default.vert", "default.frag");
+
+			overlayGao = new GAO(2);
+			overlayBatches.emplace_back(overlayGao, OVERLAY_SOLID, "default.vert", "default.frag", true, ProgramKind::Solid);
+			overlayBatches[OVERLAY_SOLID].defineVertBufferData({ 3,4 });
+			overlayBatches.emplace_back(overlayGao, OVERLAY_TEXT, "texture.vert", "text.frag");
+			overlayBatches[OVERLAY_TEXT].defineVertBufferData({ 3,4,2 });
+			overlayBatches[OVERLAY_TEXT].setBlend(true);
+			overlayBatches[OVERLAY_TEXT].addTexture(glyphAtlas.getTexture());
+
 			return true;
 		}
 
@@ -170,29 +413,146 @@ namespace voi {
 	protected:
 		virtual void Begin() = 0;
 		virtual void Update(float deltaTime) = 0;
+		/*with a fixed timestep, runs as many times as whole steps went by before each Update*/
+		virtual void FixedUpdate(float /*step*/) {}
 		virtual void Finish() = 0;
 
 		void Clear() {
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			if (renderThread.joinable()) clearRequested = true;
+			else backend->clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 			for (auto &batch : batches) {
-				batch.clearBatch();
+				if (!batch.isRetained()) batch.clearVertices();
 			}
+			lineBatch->clear();
+			pathBatch->clear();
 		}
 
 		Pixel GetClearColor() { return clearColor; }
 		void SetClearColor(const Pixel &p) {
 			clearColor = p;
-			glClearColor(p.r, p.g, p.b, p.a);
+			if (!renderThread.joinable()) backend->clearColor(p);
+		}
+
+		/*runs f where the context is current: right away, or on the render thread before the next frame is drawn
+		when there is one. with a render thread, gl can't be called from Update directly; tilemaps, particle
+		systems and emitters have to be created in Begin*/
+		void RunOnRenderThread(std::function<void()> f) {
+			if (renderThread.joinable()) renderCommands.push_back(std::move(f));
+			else f();
+		}
+
+		/*workers shared by Update and the engine. jobs spawned during Update are waited for before the frame
+		is drawn*/
+		JobSystem& GetJobs() { return jobs; }
+
+		double GetTotalTime() { return totalTime; }
+
+		/*fraction of a fixed step simulated time is behind the frame, to blend the last two states when drawing*/
+		float GetInterpolation() { return interpolation; }
+
+		/*0 goes back to a single Update per frame with the frame delta*/
+		void SetFixedTimestep(float step) {
+			config.fixedTimestep = step > 0.f ? step : 0.f;
+			stepAccumulator = 0.0;
+			interpolation = 0.f;
+		}
+		float GetFixedTimestep() { return config.fixedTimestep; }
+
+		void SetFrameLimit(float framesPerSecond) {
+			config.frameLimit = framesPerSecond;
+			limiter.setRate(framesPerSecond);
+		}
+		float GetFrameLimit() { return config.frameLimit; }
+
+		void SetVSync(bool enabled) {
+			config.vsync = enabled;
+			if (config.headless) return;
+#ifndef VOI_NO_GLFW
+			RunOnRenderThread([enabled]() { glfwSwapInterval(enabled ? 1 : 0); });
+#endif
+		}
+		bool GetVSync() { return config.vsync; }
+
+		/*counters of the last frame drawn and cpu frame times over the last frames*/
+		FrameStats GetFrameStats() {
+			FrameStats stats;
+			{
+				std::lock_guard<std::mutex> lock(statsMutex);
+				stats.draw = lastDrawStats;
+			}
+			stats.batchGrowths = batchGrowths;
+			stats.gpuTime = frameSync.getGpuTime();
+
+			if (frameTimes.size() > 0) stats.frameTime = frameTimes.get(frameTimes.size() - 1);
+			stats.frameTimeP50 = frameTimes.percentile(50.f);
+			stats.frameTimeP95 = frameTimes.percentile(95.f);
+			stats.frameTimeP99 = frameTimes.percentile(99.f);
+
+			return stats;
 		}
 
-		float GetTotalTime() { return totalTime; }
+		const FrameTimes& GetFrameTimes() { return frameTimes; }
+
+		/*graph of the frame times on the top left corner of the screen, drawn over everything after Update.
+		with a font the counters of GetFrameStats are written under it*/
+		void ShowStatsOverlay(bool show, i32 font = -1) {
+			statsOverlay = show;
+			overlayFont = font;
+		}
+
+		/*seconds from reading the input of the last frame the gpu finished to it being finished, updated every frame*/
+		float GetFrameLatency() { return frameSync.getLatency(); }
 
 		ui64 GetFrameCount() { return frameCount; }
 
+		/*NULL when headless runs on an egl context*/
 		GLFWwindow* GetWindow() { return window; }
 
+		bool IsHeadless() { return config.headless; }
+
+		/*of the backend Construct picked*/
+		const char* GetBackendName() { return backend != nullptr ? backend->getName() : ""; }
+
+		/*the loop ends after this frame and Finish runs*/
+		void Close() { closeRequested = true; }
+
+		/*reads back the frame drawn after this Update, and writes it as a png when pngPath isn't empty. reading
+		waits for the gpu to finish the frame*/
+		void CaptureNextFrame(const std::string& pngPath = "") {
+			captureRequested = true;
+			capturePath = pngPath;
+		}
+
+		/*moves out the last frame captured, RGBA8 rows from the top. false while none was read since the last
+		call, with a render thread it comes renderLatency frames later*/
+		bool TakeCapturedFrame(std::vector<ui8>& rgba, ui32& width, ui32& height) {
+			std::lock_guard<std::mutex> lock(captureMutex);
+			if (!captured) return false;
+
+			rgba.swap(capturedPixels);
+			width = capturedWidth;
+			height = capturedHeight;
+			captured = false;
+			return true;
+		}
+
+		/*changes to the camera are uploaded once before the batches are drawn*/
+		Camera2D& GetCamera() { return camera; }
+
+		Vec2f ScreenToWorld(Vec2f p) const { return camera.ScreenToWorld(p); }
+		Vec2f WorldToScreen(Vec2f p) const { return camera.WorldToScreen(p); }
+
+		/*primitives completely outside of the camera view are dropped before they reach a batch*/
+		void SetCulling(bool enabled) { cullingEnabled = enabled; }
+		bool GetCulling() { return cullingEnabled; }
+
+		// counters of the last completed frame
+		CullStats GetCullStats() { return lastCullStats; }
+
 		Pixel drawColor = { 1.0f,1.0f,1.0f,1.0f };
+		LineJoin lineJoin = LineJoin::MITER;
+		LineCap lineCap = LineCap::BUTT;
 
 		bool ChooseCurrentTextures(ui32 batch, ui32 unit = 0) {
 			if (batch >= 0 && batch < singleTexGroup.count) {
@@ -212,21 +572,7 @@ namespace voi {
 					unasignedTexBatch++;
 				}
 
-				glBindTexture(GL_TEXTURE_2D, textures[batchIndex]);
-
-
-				// set the texture wrapping/filtering options (on the currently bound texture object)
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, pixType, GL_UNSIGNED_BYTE, data);
-				if (mipmap) {
-					glGenerateMipmap(GL_TEXTURE_2D);
-				}
-
-				batches[batchIndex + singleTexGroup.position].addTexture(textures[batchIndex]);
+				uploadTexture(batchIndex, width, height, data, mipmap, pixType, true);
 
 				return batchIndex;
 			}
@@ -236,32 +582,57 @@ namespace voi {
 
 		ui32 ChangeTexture(ui32 batch, int width, int height, const ui8* data, bool mipmap = true, GLenum pixType = GL_RGBA) {
 			if (data && batch < singleTexGroup.count) {
+				uploadTexture(batch, width, height, data, mipmap, pixType, false);
 
-				glBindTexture(GL_TEXTURE_2D, textures[batch]);
+				return batch;
+			}
 
-				// set the texture wrapping/filtering options (on the currently bound texture object)
-				//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-				//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-				//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-				//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			return -1;
+		}
 
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, pixType, GL_UNSIGNED_BYTE, data);
-				if (mipmap) {
-					glGenerateMipmap(GL_TEXTURE_2D);
-				}
+		/*the texture batch is drawn alpha blended, for textures with transparent texels. blended batches still
+		write depth, what is behind them has to be drawn before*/
+		bool SetTextureBlend(ui32 batch, bool blend) {
+			if (batch >= singleTexGroup.count) return false;
 
-				//batches[batch + singleTexGroup.position].addTexture(textures[batch]);
+			// read by the thread that draws
+			RunOnRenderThread([this, batch, blend]() { batches[singleTexGroup.position + batch].setBlend(blend); });
+			return true;
+		}
 
-				return batch;
+		/*decodes the image files between the jobs, then adds them in order like AddTexture. the ids of files
+		that couldn't be read are -1*/
+		std::vector<ui32> LoadTextures(const std::vector<std::string>& paths, bool mipmap = true) {
+			std::vector<Texture> images(paths.size());
+
+			jobs.parallelFor(0, paths.size(), 1, [&](size_t from, size_t to) {
+				for (size_t i = from; i < to; i++) {
+					Texture& image = images[i];
+					image.data = stbi_load(paths[i].c_str(), &image.width, &image.height, &image.nChannels, 4);
+				}
+			});
+
+			std::vector<ui32> ids(paths.size());
+			for (size_t i = 0; i < paths.size(); i++) {
+				if (images[i].data == NULL) {
+					std::cout << "ERROR::TEXTURE::FILE_NOT_SUCCESFULLY_READ " << paths[i] << std::endl;
+					ids[i] = -1;
+					continue;
+				}
+
+				ids[i] = AddTexture(images[i].width, images[i].height, images[i].data, mipmap);
+				stbi_image_free(images[i].data);
 			}
 
-			return -1;
+			return ids;
 		}
 
 		void FillTriangle(float x1, float y1, float x2, float y2, float x3, float y3, float z = 0) {
 			FillTriangle({ x1,y1 }, { x2,y2 }, { x3,y3 }, z);
 		}
 		void FillTriangle(Vec2f p1, Vec2f p2, Vec2f p3, float z = 0) {
+			if (culled(p1, p2, p3)) return;
+
 			batches[solidGroup.current + solidGroup.position].addVertices({
 				p1.x, p1.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
 				p2.x, p2.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
@@ -274,13 +645,9 @@ namespace voi {
 			FillTriangle({ x1,y1 }, { x2,y2 }, { x3,y3 });
 		}
 		void FillQuad(Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4, float z = 0) {
+			if (culled(p1, p2, p3, p4)) return;
 
-			batches[solidGroup.current + solidGroup.position].addVertices({
-				p1.x, p1.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
-				p2.x, p2.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
-				p3.x, p3.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
-				p4.x, p4.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a
-			}, { 0, 1, 2, 2, 3, 0 });
+			addQuad(batches[solidGroup.current + solidGroup.position], p1, p2, p3, p4, z);
 		}
 
 		void FillRect(float x, float y, float w, float h, float z = 0) {
@@ -295,6 +662,7 @@ namespace voi {
 
 		void TextureTri(Vec2f p1, Vec2f p2, Vec2f p3, float z = 0,
 			Vec2f t1 = { 0.0,0.0 }, Vec2f t2 = { 1.0,0.0 }, Vec2f t3 = { 0.0,1.0 }) { 
+			if (culled(p1, p2, p3)) return;
 
 			batches[singleTexGroup.current + singleTexGroup.position].addVertices({
 				p1.x, p1.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t1.x, t1.y,
@@ -305,6 +673,7 @@ namespace voi {
 
 		void TextureQuad(Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4, float z = 0,
 			Vec2f t1 = { 0.0,0.0 }, Vec2f t2 = { 1.0,0.0 }, Vec2f t3 = { 1.0,1.0 }, Vec2f t4 = { 0.0,1.0 }) {
+			if (culled(p1, p2, p3, p4)) return;
 
 			batches[singleTexGroup.current + singleTexGroup.position].addVertices({
 				p1.x, p1.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t1.x, t1.y,
@@ -329,6 +698,7 @@ namespace voi {
 
 
 		void FillShape(const std::vector<FillVertex2D> &vertData, const std::vector<ui32> &elements) {
+			if (culled(vertData)) return;
 
 			const std::vector<float> floatData(
 				(float*)vertData.data(),
@@ -339,6 +709,7 @@ namespace voi {
 		}
 
 		void TextureShape(const std::vector<TexVertex2D>& vertData, const std::vector<ui32>& elements) {
+			if (culled(vertData)) return;
 
 			const std::vector<float> floatData(
 				(float*)vertData.data(),
@@ -348,61 +719,1146 @@ namespace voi {
 			batches[singleTexGroup.current + singleTexGroup.position].addVertices(floatData, elements);
 		}
 
+		//---polygons---//
+
+		// simple polygons of any winding, concave or with holes. triangulations are cached by the content of the
+		// polygon, so shapes that don't change between frames are only triangulated once
+		void FillPolygon(const std::vector<Vec2f>& outline, float z = 0) {
+			FillPolygon(outline.data(), outline.size(), nullptr, 0, z);
+		}
+
+		void FillPolygon(const std::vector<Vec2f>& outline, const std::vector<std::vector<Vec2f>>& holes, float z = 0) {
+			if (holes.empty()) {
+				FillPolygon(outline, z);
+				return;
+			}
+
+			polygonScratch.assign(outline.begin(), outline.end());
+			holeScratch.clear();
+			for (const auto& hole : holes) {
+				holeScratch.push_back((ui32)polygonScratch.size());
+				polygonScratch.insert(polygonScratch.end(), hole.begin(), hole.end());
+			}
+
+			FillPolygon(polygonScratch.data(), polygonScratch.size(), holeScratch.data(), holeScratch.size(), z);
+		}
+
+		/*points holds the outline followed by every hole, holeStarts the index of the first point of each hole*/
+		void FillPolygon(const Vec2f* points, size_t count, const ui32* holeStarts, size_t holeCount, float z = 0) {
+			if (count < 3 || culled(points, holeCount > 0 ? holeStarts[0] : count)) return;
+
+			const std::vector<ui32>& indices = triangulationCache.get(points, count, holeStarts, holeCount);
+			if (indices.empty()) return;
+
+			float* v = batches[solidGroup.current + solidGroup.position].addVertices((ui32)count, indices.data(), indices.size());
+
+			const float unitM[4] = { 1.f, 0.f, 0.f, 1.f };
+			WriteShapeVertices(v, 7, (const float*)points, (ui32)count, unitM, { 0.f, 0.f }, z, drawColor);
+		}
+
+		//---text---//
+
+		/*returns the id of the font, or -1 when the file couldn't be read. a font is one size of a TrueType file,
+		its glyphs are rasterized into the shared atlas the first time they are drawn*/
+		i32 LoadFont(const std::string& path, float pixelHeight) {
+			Font* font = new Font();
+			if (!font->load(path, pixelHeight)) {
+				delete font;
+				return -1;
+			}
+
+			fonts.push_back(font);
+			return (i32)fonts.size() - 1;
+		}
+
+		/*layouts are kept by the font while their text keeps being drawn. holding on to the returned pointer
+		skips even the lookup, and keeps the layout alive after the font lets go of it*/
+		std::shared_ptr<const TextLayout> LayoutText(ui32 font, const std::string& text) {
+			return findLayout(font, text);
+		}
+
+		Vec2f MeasureText(ui32 font, const std::string& text) {
+			return findLayout(font, text)->size;
+		}
+
+		// pos is the top left corner of the text, laid out with y pointing down as in pixel space
+		void DrawText(ui32 font, const std::string& text, Vec2f pos, float scale = 1.f, float z = 0) {
+			DrawText(*findLayout(font, text), pos, scale, z);
+		}
+
+		void DrawText(const TextLayout& layout, Vec2f pos, float scale = 1.f, float z = 0) {
+			const ui32 count = (ui32)layout.glyphs.size();
+			if (count == 0 || culled(pos.x, pos.y, pos.x + layout.size.x * scale, pos.y + layout.size.y * scale)) return;
+
+			addText(batches[textGroup.current + textGroup.position], layout, pos, scale, z);
+		}
+
+		//---tilemaps---//
+
+		/*width * height tiles of tileSize world units, taken from the texture AddTexture put in textureBatch,
+		cut in tilesetCols * tilesetRows tiles. tilemaps are drawn before every batch. returns the id of the map*/
+		ui32 CreateTilemap(ui32 width, ui32 height, float tileSize, ui32 textureBatch, ui32 tilesetCols, ui32 tilesetRows, ui32 chunkSize = 32) {
+			if (textureBatch >= singleTexGroup.count) {
+				throw "Outside of range Exception";
+			}
+
+			tilemaps.push_back(new Tilemap(width, height, tileSize, tileProgram, textures[textureBatch], tilesetCols, tilesetRows, chunkSize));
+			return (ui32)tilemaps.size() - 1;
+		}
+
+		Tilemap& GetTilemap(ui32 id) {
+			if (id >= tilemaps.size()) {
+				throw "Outside of range Exception";
+			}
+			return *tilemaps[id];
+		}
+
+		//---particles---//
+
+		/*particle systems are drawn after the batches, their update is left to the caller and split between the
+		jobs. returns the id of the system*/
+		ui32 CreateParticleSystem() {
+			particleSystems.push_back(new ParticleSystem(particleProgram));
+			particleSystems.back()->setJobs(&jobs);
+			return (ui32)particleSystems.size() - 1;
+		}
+
+		ParticleSystem& GetParticleSystem(ui32 id) {
+			if (id >= particleSystems.size()) {
+				throw "Outside of range Exception";
+			}
+			return *particleSystems[id];
+		}
+
+		/*emitter simulated and drawn on the gpu with a fixed number of slots, drawn after the cpu systems.
+		its update is left to the caller too. returns the id of the emitter*/
+		ui32 CreateGpuParticleEmitter(ui32 capacity, const GpuEmitterDesc& desc = GpuEmitterDesc()) {
+			gpuEmitters.push_back(new GpuParticleEmitter(capacity, gpuParticleUpdateProgram, gpuParticleProgram));
+			gpuEmitters.back()->setDesc(desc);
+			return (ui32)gpuEmitters.size() - 1;
+		}
+
+		GpuParticleEmitter& GetGpuParticleEmitter(ui32 id) {
+			if (id >= gpuEmitters.size()) {
+				throw "Outside of range Exception";
+			}
+			return *gpuEmitters[id];
+		}
+
+		//---paths---//
+
+		// filled with drawColor on the stencil buffer, curves are flattened to curveTolerance pixels on screen
+		void FillPath(const Path& path, FillRule rule = FillRule::NONZERO, float z = 0) {
+			if (path.empty()) return;
+
+			const AABB2f& box = path.getBounds();
+			if (culled(box.min.x, box.min.y, box.max.x, box.max.y)) return;
+
+			pathBatch->addPath(path, curveTolerance / camera.PixelScale(), rule, z, drawColor);
+		}
+
+		//---curved shapes---//
+
+		// the segment count follows the size on screen, so curves keep at most curveTolerance pixels of error
+		void SetCurveTolerance(float pixels) { curveTolerance = pixels; }
+
+		void FillCircle(Vec2f center, float radius, float z = 0) {
+			FillEllipse(center, radius, radius, z);
+		}
+
+		void FillEllipse(Vec2f center, float rx, float ry, float z = 0) {
+			rx = fabsf(rx); ry = fabsf(ry);
+			if (culled(center.x - rx, center.y - ry, center.x + rx, center.y + ry)) return;
+
+			const ui32 segments = curveSegments(rx > ry ? rx : ry);
+			const float m[4] = { rx, 0.f, 0.f, ry };
+
+			writeFan(shapeCache.unitCircle(segments).data(), segments, m, center, z);
+		}
+
+		/*pie slice between two angles in radians, measured from the +x axis towards the +y axis*/
+		void FillArc(Vec2f center, float radius, float startAngle, float endAngle, float z = 0) {
+			radius = fabsf(radius);
+			if (endAngle < startAngle) std::swap(startAngle, endAngle);
+			if (culled(center.x - radius, center.y - radius, center.x + radius, center.y + radius)) return;
+
+			const float span = fminf(endAngle - startAngle, 2.f * F_PI);
+			const ui32 fullSegments = curveSegments(radius);
+			const float step = 2.f * F_PI / fullSegments;
+
+			// whole steps of the cached circle rotated to the start angle, then the exact end point
+			ui32 segments = (ui32)ceilf(span / step - 1e-4f);
+			segments = segments > 0 ? segments : 1;
+
+			const float cs = cosf(startAngle) * radius, sn = sinf(startAngle) * radius;
+			const float m[4] = { cs, -sn, sn, cs };
+
+			float* v = writeFan(shapeCache.unitCircle(fullSegments).data(), segments, m, center, z);
+
+			float* last = v + (segments + 1) * 7;
+			last[0] = center.x + cosf(startAngle + span) * radius;
+			last[1] = center.y + sinf(startAngle + span) * radius;
+		}
+
+		void FillRoundedRect(float x, float y, float w, float h, float radius, float z = 0) {
+			if (w < 0) { x += w; w = -w; }
+			if (h < 0) { y += h; h = -h; }
+			if (culled(x, y, x + w, y + h)) return;
+
+			radius = fminf(fabsf(radius), fminf(w, h) * 0.5f);
+
+			// four quarters of one cached circle around the corner centers, fanned from the middle of the rect
+			const ui32 segments = curveSegments(radius);
+			const ui32 quarter = segments / 4;
+			const ui32 ringCount = (quarter + 1) * 4;
+
+			const std::vector<float>& circle = shapeCache.unitCircle(segments);
+			const ui32* fan = shapeCache.fanElements(ringCount);
+
+			std::vector<ui32> elements(fan, fan + (ringCount - 1) * 3);
+			elements.insert(elements.end(), { 0, ringCount, 1 });
+
+			float* v = batches[solidGroup.current + solidGroup.position].addVertices(ringCount + 1, elements.data(), elements.size());
+
+			const float m[4] = { radius, 0.f, 0.f, radius };
+			const Vec2f corners[4] = {
+				{ x + w - radius, y + h - radius },
+				{ x + radius,     y + h - radius },
+				{ x + radius,     y + radius },
+				{ x + w - radius, y + radius }
+			};
+
+			const float center[2] = { 0.f, 0.f };
+			const float unitM[4] = { 1.f, 0.f, 0.f, 1.f };
+			WriteShapeVertices(v, 7, center, 1, unitM, { x + w * 0.5f, y + h * 0.5f }, z, drawColor);
+
+			for (ui32 c = 0; c < 4; c++) {
+				WriteShapeVertices(v + (1 + c * (quarter + 1)) * 7, 7, circle.data() + c * quarter * 2, quarter + 1, m, corners[c], z, drawColor);
+			}
+		}
+
+		//---lines---//
+
+		// drawn with drawColor, lineJoin and lineCap. only the points are sent, the outline is built on the gpu
+		void DrawLine(Vec2f a, Vec2f b, float width, float z = 0) {
+			const Vec2f pts[2] = { a, b };
+			DrawPolyline(pts, 2, width, false, z);
+		}
+
+		void DrawPolyline(const std::vector<Vec2f>& points, float width, bool closed = false, float z = 0) {
+			DrawPolyline(points.data(), points.size(), width, closed, z);
+		}
+
+		void DrawPolyline(const Vec2f* points, size_t count, float width, bool closed = false, float z = 0) {
+			if (count < 2) return;
+
+			AABB2f box(points[0], points[0]);
+			for (size_t i = 1; i < count; i++) box.expand(points[i]);
+
+			// miters can reach MITER_LIMIT half widths away from the points
+			const float reach = width * (lineJoin == LineJoin::MITER ? 2.f : 0.5f);
+			if (culled(box.min.x - reach, box.min.y - reach, box.max.x + reach, box.max.y + reach)) return;
+
+			lineBatch->addPolyline(points, count, width, drawColor, z, lineJoin, lineCap, closed);
+		}
+
+		//---analytic shapes---//
+
+		// one quad per shape, the edge is evaluated per pixel from a distance function and antialiased.
+		// a stroke width above 0 draws only an outline of that width inside the edge
+		void FillCircleSdf(Vec2f center, float radius, float stroke = 0, float z = 0) {
+			radius = fabsf(radius);
+			sdfQuad(center, radius, radius, 0.f, stroke, 0.f, z);
+		}
+
+		void FillRoundedRectSdf(float x, float y, float w, float h, float cornerRadius, float stroke = 0, float z = 0) {
+			const float hw = fabsf(w) * 0.5f, hh = fabsf(h) * 0.5f;
+			sdfQuad({ x + w * 0.5f, y + h * 0.5f }, hw, hh, fminf(fabsf(cornerRadius), fminf(hw, hh)), stroke, 1.f, z);
+		}
+
+		void FillRingSdf(Vec2f center, float radius, float thickness, float z = 0) {
+			radius = fabsf(radius);
+			sdfQuad(center, radius, radius, fminf(fabsf(thickness), radius), 0.f, 2.f, z);
+		}
+
+		/*bulk versions of FillRect and TextureRect, culled four rects at a time and written straight into the batch,
+		big ones split between the jobs*/
+		void FillRects(const std::vector<Rect2D>& rects, float z = 0) {
+			const size_t count = visibleRects(rects);
+			if (count == 0) return;
+
+			float* v = batches[solidGroup.current + solidGroup.position].addVertices((ui32)count * 4, quadIndices((ui32)count), count * 6);
+			const Pixel c = drawColor;
+
+			jobs.parallelFor(0, count, RECTS_PER_JOB, [&](size_t from, size_t to) {
+				for (size_t i = from; i < to; i++) {
+					const Rect2D& r = rects[visibleScratch[i]];
+					const float quad[28] = {
+						      r.x,       r.y, z, c.r, c.g, c.b, c.a,
+						r.x + r.w,       r.y, z, c.r, c.g, c.b, c.a,
+						r.x + r.w, r.y + r.h, z, c.r, c.g, c.b, c.a,
+						      r.x, r.y + r.h, z, c.r, c.g, c.b, c.a
+					};
+					memcpy(v + i * 28, quad, sizeof(quad));
+				}
+			});
+		}
+
+		void TextureRects(const std::vector<Rect2D>& rects, float z = 0) {
+			const size_t count = visibleRects(rects);
+			if (count == 0) return;
+
+			float* v = batches[singleTexGroup.current + singleTexGroup.position].addVertices((ui32)count * 4, quadIndices((ui32)count), count * 6);
+			const Pixel c = drawColor;
+
+			jobs.parallelFor(0, count, RECTS_PER_JOB, [&](size_t from, size_t to) {
+				for (size_t i = from; i < to; i++) {
+					const Rect2D& r = rects[visibleScratch[i]];
+					const float quad[36] = {
+						      r.x,       r.y, z, c.r, c.g, c.b, c.a, 0.f, 0.f,
+						r.x + r.w,       r.y, z, c.r, c.g, c.b, c.a, 1.f, 0.f,
+						r.x + r.w, r.y + r.h, z, c.r, c.g, c.b, c.a, 1.f, 1.f,
+						      r.x, r.y + r.h, z, c.r, c.g, c.b, c.a, 0.f, 1.f
+					};
+					memcpy(v + i * 36, quad, sizeof(quad));
+				}
+			});
+		}
+
+		/*asks the index for the objects overlapping the camera view and calls draw with each of their handles,
+		so only those reach the batches. returns how many objects were drawn*/
+		template<typename F>
+		size_t SubmitVisible(const SpatialGrid& index, F&& draw, bool parallel = false) {
+			visibleObjects.clear();
+
+			if (parallel) index.queryParallel(camera.ViewBounds(), visibleObjects, jobs);
+			else index.query(camera.ViewBounds(), visibleObjects);
+
+			for (ui32 id : visibleObjects) draw(id);
+
+			return visibleObjects.size();
+		}
+
+		//---command lists---//
+
+		/*makes count lists ready for this frame, one for each thread that records. has to run on this thread
+		before the workers start, the lists take the camera view and culling setting of this moment*/
+		void PrepareCommandLists(ui32 count) {
+			while (commandLists.size() < count) commandLists.push_back(new CommandList());
+			for (CommandList* list : commandLists) list->reset(camera.ViewBounds(), cullingEnabled);
+		}
+
+		CommandList& GetCommandList(ui32 id) {
+			if (id >= commandLists.size()) {
+				throw "Outside of range Exception";
+			}
+			return *commandLists[id];
+		}
+
+		/*appends the lists to the batches in order of id and empties them, once every worker is done with
+		them. lists still holding primitives after Update are submitted before drawing*/
+		void SubmitCommandLists() {
+			RenderBatch& solid = batches[solidGroup.current + solidGroup.position];
+
+			for (CommandList* list : commandLists) {
+				const CullStats stats = list->getCullStats();
+				cullStats.submitted += stats.submitted;
+				cullStats.culled += stats.culled;
+
+				if (!list->empty()) {
+					appendStream(solid, list->getSolid());
+
+					const std::vector<CommandList::Stream>& textured = list->getTextured();
+					for (size_t i = 0; i < textured.size() && i < singleTexGroup.count; i++) {
+						appendStream(batches[singleTexGroup.position + i], textured[i]);
+					}
+				}
+
+				list->reset(camera.ViewBounds(), cullingEnabled);
+			}
+		}
+
+		//---transform palette---//
+
+		// shapes submitted with a transform are retained between frames, moving them only rewrites the transform
+		ui32 AddTransform(const Affine2D& transform = {}) { return palette.add(transform); }
+		void SetTransform(ui32 id, const Affine2D& transform) { palette.set(id, transform); }
+		const Affine2D& GetTransform(ui32 id) const { return palette.get(id); }
+
+		/*removes every transform and every shape that referenced them*/
+		void ClearTransformed() {
+			palette.clear();
+			batches[paletteGroup.current + paletteGroup.position].clearBatch();
+		}
+
+		// vertex positions are local to the transform
+		void FillTransformedShape(ui32 transform, const std::vector<FillVertex2D>& vertData, const std::vector<ui32>& elements) {
+			const float t = (float)transform;
+
+			std::vector<float> floatData;
+			floatData.reserve(vertData.size() * 8);
+
+			for (const auto& v : vertData) {
+				floatData.insert(floatData.end(), {
+					v.pos.pos.x, v.pos.pos.y, v.pos.z, v.color.r, v.color.g, v.color.b, v.color.a, t
+				});
+			}
+
+			batches[paletteGroup.current + paletteGroup.position].addVertices(floatData, elements);
+		}
+
+		void FillTransformedRect(ui32 transform, float x, float y, float w, float h, float z = 0) {
+			const float t = (float)transform;
+
+			batches[paletteGroup.current + paletteGroup.position].addVertices({
+				    x,     y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t,
+				x + w,     y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t,
+				x + w, y + h, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t,
+				    x, y + h, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, t
+			}, { 0, 1, 2, 2, 3, 0 });
+		}
+
 		
 
 	private:
 
+		bool culled(float minX, float minY, float maxX, float maxY) {
+			cullStats.submitted++;
+
+			if (cullingEnabled && OutsideView(camera.ViewBounds(), minX, minY, maxX, maxY)) {
+				cullStats.culled++;
+				return true;
+			}
+			return false;
+		}
+		bool culled(Vec2f p1, Vec2f p2, Vec2f p3) {
+			return culled(
+				fminf(p1.x, fminf(p2.x, p3.x)), fminf(p1.y, fminf(p2.y, p3.y)),
+				fmaxf(p1.x, fmaxf(p2.x, p3.x)), fmaxf(p1.y, fmaxf(p2.y, p3.y))
+			);
+		}
+		bool culled(Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4) {
+			return culled(
+				fminf(fminf(p1.x, p2.x), fminf(p3.x, p4.x)), fminf(fminf(p1.y, p2.y), fminf(p3.y, p4.y)),
+				fmaxf(fmaxf(p1.x, p2.x), fmaxf(p3.x, p4.x)), fmaxf(fmaxf(p1.y, p2.y), fmaxf(p3.y, p4.y))
+			);
+		}
+		bool culled(const Vec2f* points, size_t count) {
+			if (count == 0) return true;
+
+			AABB2f box(points[0], points[0]);
+			for (size_t i = 1; i < count; i++) box.expand(points[i]);
+
+			return culled(box.min.x, box.min.y, box.max.x, box.max.y);
+		}
+		template<typename V>
+		bool culled(const std::vector<V>& vertData) {
+			if (vertData.empty()) return true;
+
+			AABB2f box(vertData[0].pos.pos, vertData[0].pos.pos);
+			for (const auto& v : vertData) box.expand(v.pos.pos);
+
+			return culled(box.min.x, box.min.y, box.max.x, box.max.y);
+		}
+
+		void sdfQuad(Vec2f center, float hw, float hh, float corner, float stroke, float type, float z) {
+			// one extra pixel around the shape leaves room for the antialiased edge
+			const float margin = 1.f / camera.PixelScale();
+			const float ex = hw + margin, ey = hh + margin;
+
+			if (culled(center.x - ex, center.y - ey, center.x + ex, center.y + ey)) return;
+
+			static const ui32 quad[6] = { 0, 1, 2, 2, 3, 0 };
+			float* v = batches[sdfGroup.current + sdfGroup.position].addVertices(4, quad, 6);
+
+			const float corners[4][2] = { { -ex, -ey }, { ex, -ey }, { ex, ey }, { -ex, ey } };
+			for (int i = 0; i < 4; i++) {
+				const float lx = corners[i][0], ly = corners[i][1];
+				const float vert[14] = {
+					center.x + lx, center.y + ly, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
+					lx, ly, hw, hh, corner, stroke, type
+				};
+				std::copy(vert, vert + 14, v + i * 14);
+			}
+		}
+
+		/*with a render thread the pixels are copied and sent from it before the next frame*/
+		void uploadTexture(ui32 batch, int width, int height, const ui8* data, bool mipmap, GLenum pixType, bool add) {
+			auto upload = [this, batch, width, height, mipmap, pixType, add](const ui8* pixels) {
+				// set the texture wrapping/filtering options
+				if (add) backend->textureSampling(textures[batch], GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+
+				backend->textureImage(textures[batch], width, height, pixType, pixels, mipmap);
+				DrawCounters().textureBytes += (ui64)width * height * PixelBytes(pixType);
+
+				if (add) batches[batch + singleTexGroup.position].addTexture(textures[batch]);
+			};
+
+			if (!renderThread.joinable()) {
+				upload(data);
+				return;
+			}
+
+			const size_t bytes = (size_t)width * height * PixelBytes(pixType);
+			std::vector<ui8> pixels(data, data + bytes);
+			renderCommands.push_back([upload, pixels]() { upload(pixels.data()); });
+		}
+
+		static size_t PixelBytes(GLenum pixType) {
+			switch (pixType) {
+			case GL_RED: return 1;
+			case GL_RG: return 2;
+			case GL_RGB: case GL_BGR: return 3;
+			default: return 4;
+			}
+		}
+
+		static void appendStream(RenderBatch& batch, const CommandList::Stream& stream) {
+			if (stream.vertexCount == 0) return;
+
+			float* v = batch.addVertices(stream.vertexCount, stream.elements.data(), stream.elements.size());
+			std::memcpy(v, stream.vertices.data(), stream.vertices.size() * sizeof(float));
+		}
+
+		static ui32 loadProgram(const char* vertexPath, const char* fragmentPath) {
+			std::ifstream vertexFile(vertexPath), fragmentFile(fragmentPath);
+			std::stringstream vertexStream, fragmentStream;
+
+			vertexStream << vertexFile.rdbuf();
+			fragmentStream << fragmentFile.rdbuf();
+
+			vertexFile.close(); fragmentFile.close();
+
+			return Backend().createProgram(vertexStream.str(), fragmentStream.str());
+		}
+
+		/*0,1,2, 2,3,0 for at least count quads of 4 vertices*/
+		const ui32* quadIndices(ui32 count) {
+			const ui32 have = (ui32)quadElements.size() / 6;
+			if (have < count) {
+				quadElements.reserve(count * 6);
+				for (ui32 q = have; q < count; q++) {
+					const ui32 b = q * 4;
+					quadElements.insert(quadElements.end(), { b, b + 1, b + 2, b + 2, b + 3, b });
+				}
+			}
+			return quadElements.data();
+		}
+
+		ui32 curveSegments(float radius) {
+			return ShapeCache::SegmentsFor(radius * camera.PixelScale(), curveTolerance);
+		}
+
+		/*center vertex plus segments + 1 points of the unit circle through m and center, as a triangle fan
+		into the solid batch. returns the written vertices*/
+		float* writeFan(const float* circle, ui32 segments, const float m[4], Vec2f center, float z) {
+			const ui32* fan = shapeCache.fanElements(segments);
+			float* v = batches[solidGroup.current + solidGroup.position].addVertices(segments + 2, fan, segments * 3);
+
+			const float origin[2] = { 0.f, 0.f };
+			WriteShapeVertices(v, 7, origin, 1, m, center, z, drawColor);
+			WriteShapeVertices(v + 7, 7, circle, segments + 1, m, center, z, drawColor);
+
+			return v;
+		}
+
+		/*fills visibleScratch with the indices of the rects to draw and returns how many there are. big arrays
+		are culled in parts between the jobs, then the parts are packed back in order*/
+		size_t visibleRects(const std::vector<Rect2D>& rects) {
+			const size_t n = rects.size();
+			visibleScratch.resize(n);
+			cullStats.submitted += n;
+
+			if (!cullingEnabled) {
+				for (size_t i = 0; i < n; i++) visibleScratch[i] = (ui32)i;
+				return n;
+			}
+
+			const AABB2f view = camera.ViewBounds();
+			size_t parts = jobs.getWorkerCount() + 1;
+			parts = parts < n / RECTS_PER_JOB ? parts : n / RECTS_PER_JOB;
+
+			size_t count;
+			if (parts <= 1) {
+				count = CullRects(rects.data(), n, view, visibleScratch.data());
+			}
+			else {
+				// parts start on multiples of 4 so only the last one has a scalar tail
+				const size_t step = ((n / parts) + 3) & ~(size_t)3;
+				visibleCounts.assign(parts, 0);
+
+				jobs.parallelFor(0, parts, 1, [&](size_t from, size_t to) {
+					for (size_t p = from; p < to; p++) {
+						const size_t begin = step * p, end = p + 1 < parts ? step * (p + 1) : n;
+						if (begin >= n) continue;
+
+						ui32* out = visibleScratch.data() + begin;
+						const size_t written = CullRects(rects.data() + begin, (end < n ? end : n) - begin, view, out);
+						for (size_t i = 0; i < written; i++) out[i] += (ui32)begin;
+						visibleCounts[p] = written;
+					}
+				});
+
+				count = visibleCounts[0];
+				for (size_t p = 1; p < parts; p++) {
+					if (visibleCounts[p] == 0) continue;
+					memmove(visibleScratch.data() + count, visibleScratch.data() + step * p, visibleCounts[p] * sizeof(ui32));
+					count += visibleCounts[p];
+				}
+			}
+
+			cullStats.culled += n - count;
+			return count;
+		}
+
+		/*a window, or headless an egl context when built with VOI_EGL, falling back to a hidden window*/
+		bool createContext(const char* title, ui32 width, ui32 height) {
+			if (config.nullGL) return gladLoadGLLoader(NullGL::Loader()) != 0;
+
+#ifdef VOI_EGL
+			if (config.headless) {
+				if (headlessContext.create()) {
+					if (!gladLoadGLLoader(HeadlessContext::Loader())) {
+						std::cout << "Failed to initialize GLAD" << std::endl;
+						return false;
+					}
+					return true;
+				}
+				std::cout << "Failed to create EGL context, using a hidden window" << std::endl;
+			}
+#endif
+#ifdef VOI_NO_GLFW
+			(void)title; (void)width; (void)height;
+			std::cout << "ERROR::CONTEXT::BUILT_WITHOUT_GLFW" << std::endl;
+			return false;
+#else
+			glfwStarted = glfwInit() == GLFW_TRUE;
+			if (!glfwStarted) {
+				std::cout << "Failed to initialize GLFW" << std::endl;
+				return false;
+			}
+			/*hints at the version of openGL to use (3.3)*/
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+			/*hints that we want to use the core mode in openGL*/
+			glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+			/*depth for the z of the primitives, stencil for filling paths*/
+			glfwWindowHint(GLFW_DEPTH_BITS, 24);
+			glfwWindowHint(GLFW_STENCIL_BITS, 8);
+			glfwWindowHint(GLFW_VISIBLE, config.headless ? GLFW_FALSE : GLFW_TRUE);
+
+			/*creates the window*/
+			window = glfwCreateWindow(width, height, title, NULL, NULL);
+
+			if (window == NULL) {
+				std::cout << "Failed to create GLFW window" << std::endl;
+				return false;
+			}
+
+			/*makes the created window the current context in wich glfw works*/
+			glfwMakeContextCurrent(window);
+			glfwSetWindowAttrib(window, GLFW_RESIZABLE, GLFW_FALSE);
+
+			/*GLAD initialization*/
+			if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+				std::cout << "Failed to initialize GLAD" << std::endl;
+				return false;
+			}
+
+			/*sets function to callback when window is rezised*/
+			if (!config.headless) glfwSetFramebufferSizeCallback(window, viewportResize);
+			return true;
+#endif
+		}
+
+		/*once gl is loaded, GL45 falls back to GL33 on older contexts*/
+		void createBackend() {
+			if (config.backend == BackendType::Software) backend = new SoftwareBackend(jobs);
+			else if (config.backend == BackendType::GL45 && GL45Backend::Supported()) backend = new GL45Backend();
+			else {
+				if (config.backend == BackendType::GL45) std::cout << "GL 4.5 not supported, using the GL 3.3 backend" << std::endl;
+				backend = new GL33Backend();
+			}
+			CurrentBackend() = backend;
+		}
+
+		/*takes the context to the calling thread, or off it*/
+		void makeCurrent(bool current) {
+			if (config.nullGL) return;
+#ifdef VOI_EGL
+			if (headlessContext.isCreated()) {
+				headlessContext.makeCurrent(current);
+				return;
+			}
+#endif
+#ifndef VOI_NO_GLFW
+			glfwMakeContextCurrent(current ? window : NULL);
+#else
+			(void)current;
+#endif
+		}
+
+		/*lastFrame is the frame count the loop stops at, 0 when there is none*/
+		bool shouldClose(ui64 lastFrame) {
+			if (closeRequested) return true;
+			if (lastFrame > 0 && frameCount >= lastFrame) return true;
+#ifndef VOI_NO_GLFW
+			return window != NULL && glfwWindowShouldClose(window);
+#else
+			return false;
+#endif
+		}
+
+		/*seconds since Construct*/
+		double now() const { return FrameLimiter::Now() - startTime; }
+
+		void present() {
+#ifndef VOI_NO_GLFW
+			if (!config.headless) glfwSwapBuffers(window);
+#endif
+		}
+
+		/*on the thread that draws, before the swap while the frame is still in the back buffer*/
+		void captureFrame(const std::string& path) {
+			VOI_PROFILE_SCOPE("capture");
+
+			i32 width = 0, height = 0;
+			if (offscreen.isCreated()) {
+				width = (i32)offscreen.getWidth();
+				height = (i32)offscreen.getHeight();
+			}
+#ifndef VOI_NO_GLFW
+			else glfwGetFramebufferSize(window, &width, &height);
+#endif
+
+			std::vector<ui8> pixels;
+			backend->readPixels((ui32)width, (ui32)height, pixels);
+			if (!path.empty()) WritePng(path, (ui32)width, (ui32)height, pixels.data());
+
+			std::lock_guard<std::mutex> lock(captureMutex);
+			capturedPixels.swap(pixels);
+			capturedWidth = (ui32)width;
+			capturedHeight = (ui32)height;
+			captured = true;
+		}
+
 		void First() {
-			loopStartT = glfwGetTime();
+			loopStartT = now();
 			loopEndT = loopStartT;
 
 
 			this->Begin();
+			jobs.waitFrame();
 
 
 			for (auto& batch : batches) { batch.enableVAA(); }
+			for (auto& batch : overlayBatches) { batch.enableVAA(); }
 
-			glClear(GL_COLOR_BUFFER_BIT);
+			backend->clear(GL_COLOR_BUFFER_BIT);
 
-			for(auto &batch: batches) { batch.DrawBatch(); }
-			glfwSwapBuffers(window);
+			drawBatches();
+			present();
 
-			glClear(GL_COLOR_BUFFER_BIT);
+			backend->clear(GL_COLOR_BUFFER_BIT);
 
-			for (auto &batch : batches) { batch.DrawBatch(); }
-			glfwSwapBuffers(window);
+			drawBatches();
+			present();
 
 			frameCount++;
 
 			this->Loop();
 		}
 		void Loop() {
-			float elapsed = 0;
-			while (!glfwWindowShouldClose(window)) {
-				loopEndT = glfwGetTime();
+			if (config.renderLatency > 0) startRenderThread();
+
+			// the frames drawn by First don't count
+			DrawCounters() = DrawStats();
+
+			const ui64 lastFrame = config.headlessFrames > 0 ? frameCount + config.headlessFrames : 0;
+
+			double elapsed = 0;
+			while (!shouldClose(lastFrame)) {
+				// input is read as late as possible, right before the frame that reacts to it
+#ifndef VOI_NO_GLFW
+				if (window != NULL) glfwPollEvents();
+#endif
+
+				loopEndT = now();
 				totalTime = loopEndT;
+				VOI_PROFILE_FRAME(frameCount);
 
 				elapsed = loopEndT - loopStartT;
 				loopStartT = loopEndT;
+				frameTimes.add((float)elapsed);
 
-				this->Update(elapsed);
+				lastCullStats = cullStats;
+				cullStats = {};
 
-				for (auto &batch : batches) {
-					batch.DrawBatch();
+				if (config.fixedTimestep > 0.f) fixedSteps(elapsed);
+
+				{
+					VOI_PROFILE_SCOPE("Update");
+					this->Update((float)elapsed);
+					jobs.waitFrame();
 				}
+				SubmitCommandLists();
+
+				batchGrowths = 0;
+				for (auto& batch : batches) batchGrowths += batch.takeGrowths();
+				if (statsOverlay) drawStatsOverlay();
 
-				glfwSwapBuffers(window);
+				if (renderThread.joinable()) {
+					VOI_PROFILE_SCOPE("capture packet");
+					FramePacket* packet = frames.acquire();
+					capturePacket(*packet);
+					frames.submit(packet);
+				}
+				else {
+					frameSync.beginFrame();
+					drawBatches();
+					swapBuffers(loopEndT, captureRequested, capturePath);
+					captureRequested = false;
+				}
 
 				frameCount++;
+				triangulationCache.endFrame();
+				for (Font* font : fonts) font->endFrame();
 
-				glfwPollEvents();
+				VOI_PROFILE_SCOPE("frame limiter");
+				limiter.wait();
 			}
 
+			if (renderThread.joinable()) stopRenderThread();
+
 			this->Finish();
 		}
 
+		/*runs the whole steps that fit in the time left over plus elapsed, keeping the remainder for the next frame*/
+		void fixedSteps(double elapsed) {
+			const double step = config.fixedTimestep;
+			const double most = step * config.maxFixedSteps;
+
+			stepAccumulator += elapsed < most ? elapsed : most;
+			while (stepAccumulator >= step) {
+				VOI_PROFILE_SCOPE("FixedUpdate");
+				this->FixedUpdate((float)step);
+				jobs.waitFrame();
+				stepAccumulator -= step;
+			}
+
+			interpolation = (float)(stepAccumulator / step);
+		}
+
+		/*swaps on the thread owning the context, then waits while too many frames are in flight*/
+		void swapBuffers(double inputTime, bool capture, const std::string& capturePath) {
+			backend->finishFrame();
+			if (capture) captureFrame(capturePath);
+
+			{
+				VOI_PROFILE_SCOPE("swap");
+				present();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(statsMutex);
+				lastDrawStats = DrawCounters();
+			}
+			DrawCounters() = DrawStats();
+
+			VOI_PROFILE_SCOPE("frames in flight");
+			frameSync.endFrame(inputTime, now());
+		}
+
+		void addQuad(RenderBatch& batch, Vec2f p1, Vec2f p2, Vec2f p3, Vec2f p4, float z) {
+			batch.addVertices({
+				p1.x, p1.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
+				p2.x, p2.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
+				p3.x, p3.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a,
+				p4.x, p4.y, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a
+			}, { 0, 1, 2, 2, 3, 0 });
+		}
+
+		/*the one the font keeps, only good until its next endFrame unless it is copied*/
+		const std::shared_ptr<TextLayout>& findLayout(ui32 font, const std::string& text) {
+			if (font >= fonts.size()) {
+				throw "Outside of range Exception";
+			}
+			return fonts[font]->layout(text, glyphAtlas);
+		}
+
+		void addText(RenderBatch& batch, const TextLayout& layout, Vec2f pos, float scale, float z) {
+			const ui32 count = (ui32)layout.glyphs.size();
+			if (count == 0) return;
+
+			float* v = batch.addVertices(count * 4, quadIndices(count), count * 6);
+
+			// in texels, text.frag divides by the size the atlas has when it is drawn, it may grow later this frame
+			for (const Glyph& g : layout.glyphs) {
+				const float x0 = pos.x + g.x0 * scale, y0 = pos.y + g.y0 * scale;
+				const float x1 = pos.x + g.x1 * scale, y1 = pos.y + g.y1 * scale;
+				const float u0 = g.ax, v0 = g.ay;
+				const float u1 = (float)(g.ax + g.aw), v1 = (float)(g.ay + g.ah);
+
+				const float quad[36] = {
+					x0, y0, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, u0, v0,
+					x1, y0, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, u1, v0,
+					x1, y1, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, u1, v1,
+					x0, y1, z, drawColor.r, drawColor.g, drawColor.b, drawColor.a, u0, v1
+				};
+				std::copy(quad, quad + 36, v);
+				v += 36;
+			}
+		}
+
+		/*bars of the last frame times, green under 1/60 s, yellow under 1/30 s and red above, in front of
+		everything. corners are taken from the screen so the camera doesn't move it. it goes in the overlay
+		batches, emptied here every frame, so none of it ends up in the batches of the user*/
+		void drawStatsOverlay() {
+			const Pixel color = drawColor;
+			for (auto& batch : overlayBatches) batch.clearVertices();
+
+			const float z = -1.f;
+			const float left = 8.f, top = 8.f, height = 100.f;
+			// a frame of 1/15 s fills the height
+			const float pixelsPerSecond = height * 15.f;
+
+			auto screenQuad = [&](float x, float y, float w, float h) {
+				addQuad(overlayBatches[OVERLAY_SOLID], ScreenToWorld({ x, y }), ScreenToWorld({ x + w, y }), ScreenToWorld({ x + w, y + h }), ScreenToWorld({ x, y + h }), z);
+			};
+
+			const ui32 count = frameTimes.size();
+			drawColor = { 0.05f, 0.05f, 0.05f, 1.f };
+			screenQuad(left, top, 240.f, height);
+
+			for (ui32 i = 0; i < count; i++) {
+				const float t = frameTimes.get(i);
+				const float h = fminf(t * pixelsPerSecond, height);
+
+				if (t < 1.f / 59.f) drawColor = { 0.2f, 0.8f, 0.2f, 1.f };
+				else if (t < 1.f / 29.f) drawColor = { 0.9f, 0.8f, 0.1f, 1.f };
+				else drawColor = { 0.9f, 0.2f, 0.2f, 1.f };
+
+				screenQuad(left + 240.f - count + i, top + height - h, 1.f, h);
+			}
+
+			drawColor = { 1.f, 1.f, 1.f, 1.f };
+			screenQuad(left, top + height - pixelsPerSecond / 60.f, 240.f, 1.f);
+
+			if (overlayFont >= 0 && (size_t)overlayFont < fonts.size()) {
+				const FrameStats s = GetFrameStats();
+				const float kb = 1.f / 1024.f;
+
+				char lines[4][160];
+				snprintf(lines[0], sizeof(lines[0]), "frame %.2f ms  p50 %.2f  p95 %.2f  p99 %.2f  gpu %.2f",
+					s.frameTime * 1000.f, s.frameTimeP50 * 1000.f, s.frameTimeP95 * 1000.f, s.frameTimeP99 * 1000.f, s.gpuTime * 1000.f);
+				snprintf(lines[1], sizeof(lines[1]), "draws %llu  vertices %llu  indices %llu",
+					(unsigned long long)s.draw.drawCalls, (unsigned long long)s.draw.vertices, (unsigned long long)s.draw.indices);
+				snprintf(lines[2], sizeof(lines[2]), "upload KB  vertex %.1f  element %.1f  texture %.1f  other %.1f",
+					s.draw.vertexBytes * kb, s.draw.elementBytes * kb, s.draw.textureBytes * kb, s.draw.otherBytes * kb);
+				snprintf(lines[3], sizeof(lines[3]), "binds %llu  programs %llu  reallocations %llu  growths %llu",
+					(unsigned long long)s.draw.textureBinds, (unsigned long long)s.draw.programSwitches,
+					(unsigned long long)s.draw.bufferReallocations, (unsigned long long)s.batchGrowths);
+
+				const float scale = 1.f / camera.PixelScale();
+				float y = top + height + 4.f;
+				for (const char* line : lines) {
+					const TextLayout& layout = *findLayout((ui32)overlayFont, line);
+					addText(overlayBatches[OVERLAY_TEXT], layout, ScreenToWorld({ left, y }), scale, z);
+					y += layout.size.y + 2.f;
+				}
+			}
+
+			drawColor = color;
+		}
+
+		/*the context moves to the render thread until the loop ends*/
+		void startRenderThread() {
+			frames.init(config.renderLatency);
+
+			makeCurrent(false);
+			renderThread = std::thread(&VoiOGLEngine::renderLoop, this);
+		}
+
+		void stopRenderThread() {
+			frames.close();
+			renderThread.join();
+
+			makeCurrent(true);
+			backend->clearColor(clearColor);
+		}
+
+		void renderLoop() {
+			makeCurrent(true);
+
+			while (FramePacket* packet = frames.next()) {
+				frameSync.beginFrame();
+				drawPacket(*packet);
+				swapBuffers(packet->inputTime, packet->capture, packet->capturePath);
+				frames.release(packet);
+			}
+
+			makeCurrent(false);
+		}
+
+		/*runs on the thread of Update, copies what changed so the simulation can go on with the next frame*/
+		void capturePacket(FramePacket& packet) {
+			packet.frame = frameCount;
+			packet.inputTime = loopEndT;
+
+			packet.capture = captureRequested;
+			packet.capturePath = capturePath;
+			captureRequested = false;
+
+			packet.clear = clearRequested;
+			packet.clearColor = clearColor;
+			clearRequested = false;
+
+			packet.cameraChanged = camera.IsDirty();
+			if (packet.cameraChanged) {
+				camera.ViewProjection(packet.viewProj);
+				camera.ClearDirty();
+			}
+
+			packet.commands.swap(renderCommands);
+			renderCommands.clear();
+
+			palette.capture(packet.palette);
+			glyphAtlas.capture(packet.glyphs);
+
+			packet.tilemaps.resize(tilemaps.size());
+			for (size_t i = 0; i < tilemaps.size(); i++) {
+				packet.tilemaps[i].object = tilemaps[i];
+				tilemaps[i]->prepare(camera.ViewBounds(), packet.tilemaps[i].data);
+			}
+
+			packet.batches.resize(batches.size());
+			for (size_t i = 0; i < batches.size(); i++) {
+				batches[i].capture(packet.batches[i]);
+			}
+
+			packet.particles.resize(particleSystems.size());
+			for (size_t i = 0; i < particleSystems.size(); i++) {
+				packet.particles[i].object = particleSystems[i];
+				particleSystems[i]->capture(packet.particles[i].data);
+			}
+
+			packet.emitters.resize(gpuEmitters.size());
+			for (size_t i = 0; i < gpuEmitters.size(); i++) {
+				packet.emitters[i].object = gpuEmitters[i];
+				gpuEmitters[i]->capture(packet.emitters[i].data);
+			}
+
+			lineBatch->capture(packet.lines);
+			pathBatch->capture(packet.paths);
+
+			packet.overlay.resize(statsOverlay ? overlayBatches.size() : 0);
+			for (size_t i = 0; i < packet.overlay.size(); i++) {
+				overlayBatches[i].capture(packet.overlay[i]);
+			}
+		}
+
+		/*runs on the render thread, in the same order as drawBatches*/
+		void drawPacket(FramePacket& packet) {
+			VOI_PROFILE_GPU_FRAME(packet.frame);
+			VOI_PROFILE_SCOPE("drawPacket");
+
+			for (auto& command : packet.commands) command();
+			packet.commands.clear();
+
+			if (packet.clear) {
+				backend->clearColor(packet.clearColor);
+				backend->clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+			}
+
+			if (packet.cameraChanged) writeCamera(packet.viewProj);
+			palette.upload(packet.palette);
+			glyphAtlas.upload(packet.glyphs);
+
+			for (auto& map : packet.tilemaps) {
+				VOI_PROFILE_GPU_SCOPE("tilemap", -1);
+				map.object->draw(map.data);
+			}
+
+			for (size_t i = 0; i < packet.batches.size(); i++) {
+				batches[i].DrawBatch(packet.batches[i]);
+			}
+			for (auto& system : packet.particles) {
+				VOI_PROFILE_GPU_SCOPE("particles", -1);
+				system.object->draw(system.data);
+			}
+			for (auto& emitter : packet.emitters) {
+				VOI_PROFILE_GPU_SCOPE("gpu particles", -1);
+				emitter.object->draw(emitter.data);
+			}
+			{
+				VOI_PROFILE_GPU_SCOPE("lines", -1);
+				lineBatch->DrawBatch(packet.lines);
+			}
+			{
+				VOI_PROFILE_GPU_SCOPE("paths", -1);
+				pathBatch->DrawBatch(packet.paths);
+			}
+			for (size_t i = 0; i < packet.overlay.size(); i++) {
+				overlayBatches[i].DrawBatch(packet.overlay[i]);
+			}
+		}
+
+		void drawBatches() {
+			VOI_PROFILE_GPU_FRAME(frameCount);
+			VOI_PROFILE_SCOPE("drawBatches");
+
+			uploadCamera();
+			palette.upload();
+			glyphAtlas.flush();
+
+			for (Tilemap* map : tilemaps) {
+				VOI_PROFILE_GPU_SCOPE("tilemap", -1);
+				map->draw(camera.ViewBounds());
+			}
+
+			for (auto& batch : batches) {
+				batch.DrawBatch();
+			}
+			for (ParticleSystem* system : particleSystems) {
+				VOI_PROFILE_GPU_SCOPE("particles", -1);
+				system->draw();
+			}
+			for (GpuParticleEmitter* emitter : gpuEmitters) {
+				VOI_PROFILE_GPU_SCOPE("gpu particles", -1);
+				emitter->draw();
+			}
+			{
+				VOI_PROFILE_GPU_SCOPE("lines", -1);
+				lineBatch->DrawBatch();
+			}
+			{
+				VOI_PROFILE_GPU_SCOPE("paths", -1);
+				pathBatch->DrawBatch();
+			}
+			if (statsOverlay) {
+				for (auto& batch : overlayBatches) batch.DrawBatch();
+			}
+		}
+
+		void uploadCamera() {
+			if (!camera.IsDirty()) return;
+
+			float viewProj[16];
+			camera.ViewProjection(viewProj);
+
+			writeCamera(viewProj);
+			camera.ClearDirty();
+		}
+
+		void writeCamera(const float* viewProj) {
+			backend->bufferSubData(cameraUbo, 0, 16 * sizeof(float), viewProj);
+			DrawCounters().otherBytes += 16 * sizeof(float);
+		}
+
+#ifndef VOI_NO_GLFW
 		static void viewportResize(GLFWwindow* window, int width, int height) {
-			glViewport(0, 0, width, height);
+			Backend().viewport(0, 0, width, height);
 		}
+#endif
 	};
 }
@@ -8,10 +8,16 @@
 #include <fstream>
 #include <sstream>
 
+#include "FrameStats.h"
+#include "RenderBackend.h"
+
 class Shader {
 	uint32_t id;
 public:
-	Shader(const std::string& vertexStr, const std::string& fragmentStr, bool path = true) {
+	/*uniform block binding points shared by every program*/
+	static const uint32_t CAMERA_BLOCK_BINDING = 0;
+
+	Shader(const std::string& vertexStr, const std::string& fragmentStr, bool path = true, voi::ProgramKind kind = voi::ProgramKind::Other) {
 		std::string vertexCode = vertexStr, fragmentCode = fragmentStr;
 
 		if (path) {
@@ -26,11 +32,11 @@ public:
 			vertexFile.close(); fragmentFile.close();
 		}
 
-		id = programLinking(vertexCode, fragmentCode);
+		id = voi::Backend().createProgram(vertexCode, fragmentCode, kind);
 	}
 
 	Shader(uint32_t _id) {
-		if (glIsProgram(_id)) {
+		if (voi::Backend().isProgram(_id)) {
 			id = _id;
 		}
 		else {
@@ -39,7 +45,15 @@ public:
 		}
 	}
 
-	void use() { glUseProgram(id); }
+	void use() {
+		// program of the last use, so only real switches are counted
+		static uint32_t current = 0;
+		if (id != current) {
+			voi::DrawCounters().programSwitches++;
+			current = id;
+		}
+		voi::Backend().useProgram(id);
+	}
 
 	void setBool(const std::string& name, bool val) {
 		glUniform1i(
@@ -110,6 +124,7 @@ public:
 		return success;
 	}
 
+	/*what the gl backends compile programs with*/
 	static uint32_t programLinking(const std::string& vertexCode,const std::string& fragmentCode) {
 		uint32_t linkId = glCreateProgram();
 
@@ -124,11 +139,39 @@ public:
 		/*check for errors*/
 		LINKLOG(linkId);
 
+		bindUniformBlock(linkId, "Camera", CAMERA_BLOCK_BINDING);
+
 		glDeleteShader(vertex); glDeleteShader(fragment);
 
 		return linkId;
 	}
 
+	/*vertex only program whose outputs are captured with transform feedback, interleaved in the order of
+	varyings. the varyings have to be given before linking*/
+	static uint32_t feedbackProgramLinking(const std::string& vertexCode, const char* const* varyings, uint32_t varyingCount) {
+		uint32_t linkId = glCreateProgram();
+
+		uint32_t vertex = shaderCompilation(vertexCode.c_str(), GL_VERTEX_SHADER);
+		glAttachShader(linkId, vertex);
+
+		glTransformFeedbackVaryings(linkId, varyingCount, varyings, GL_INTERLEAVED_ATTRIBS);
+		glLinkProgram(linkId);
+		LINKLOG(linkId);
+
+		glDeleteShader(vertex);
+
+		return linkId;
+	}
+
+	/*programs that don't declare the block are left untouched*/
+	static void bindUniformBlock(uint32_t linkId, const char* name, uint32_t binding) {
+		uint32_t blockIndex = glGetUniformBlockIndex(linkId, name);
+
+		if (blockIndex != GL_INVALID_INDEX) {
+			glUniformBlockBinding(linkId, blockIndex, binding);
+		}
+	}
+
 	static void LINKLOG(uint32_t linkId) {
 		int success;
 
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define VOI_SHAPE_SSE
+#endif
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Pixel.h"
+
+namespace voi {
+	/*unit circles tessellated once per segment count, curved shapes are built by scaling and moving them*/
+	class ShapeCache {
+		// n + 1 points (x, y) around the unit circle, the last one repeats the first
+		std::unordered_map<ui32, std::vector<float>> circles;
+		// triangle fan around vertex 0: 0,1,2, 0,2,3, 0,3,4 ...
+		std::vector<ui32> fan;
+
+	public:
+		static constexpr ui32 MIN_SEGMENTS = 8;
+		static constexpr ui32 MAX_SEGMENTS = 512;
+
+		/*smallest segment count (multiple of 8) that keeps the chords within tolerance pixels of the curve*/
+		static ui32 SegmentsFor(float radiusPixels, float tolerance = 0.25f) {
+			if (radiusPixels <= tolerance) return MIN_SEGMENTS;
+
+			const ui32 n = (ui32)ceilf(F_PI / acosf(1.f - tolerance / radiusPixels));
+			const ui32 rounded = (n + 7) & ~7u;
+
+			return rounded < MIN_SEGMENTS ? MIN_SEGMENTS : (rounded > MAX_SEGMENTS ? MAX_SEGMENTS : rounded);
+		}
+
+		const std::vector<float>& unitCircle(ui32 segments) {
+			auto it = circles.find(segments);
+			if (it != circles.end()) return it->second;
+
+			std::vector<float>& points = circles[segments];
+			points.resize((segments + 1) * 2);
+
+			const double step = 2.0 * D_PI / segments;
+			for (ui32 i = 0; i < segments; i++) {
+				points[i * 2] = (float)cos(step * i);
+				points[i * 2 + 1] = (float)sin(step * i);
+			}
+			points[segments * 2] = points[0];
+			points[segments * 2 + 1] = points[1];
+
+			return points;
+		}
+
+		/*fan with at least count triangles*/
+		const ui32* fanElements(ui32 count) {
+			const ui32 have = (ui32)fan.size() / 3;
+			if (have < count) {
+				fan.reserve(count * 3);
+				for (ui32 i = have; i < count; i++) {
+					fan.insert(fan.end(), { 0, i + 1, i + 2 });
+				}
+			}
+			return fan.data();
+		}
+	};
+
+	/*writes count points of the form m * p + t into the position of consecutive vertices of stride floats,
+	followed by z and color. m is the 2x2 matrix { m00, m01, m10, m11 }*/
+	inline void WriteShapeVertices(float* out, ui32 stride, const float* points, ui32 count,
+		const float m[4], Vec2f t, float z, const Pixel& color) {
+
+		ui32 i = 0;
+
+#ifdef VOI_SHAPE_SSE
+		const __m128 colX = _mm_setr_ps(m[0], m[2], m[0], m[2]);
+		const __m128 colY = _mm_setr_ps(m[1], m[3], m[1], m[3]);
+		const __m128 offset = _mm_setr_ps(t.x, t.y, t.x, t.y);
+		const __m128 tail = _mm_setr_ps(z, color.r, color.g, color.b);
+
+		// two points per iteration: (x0, y0, x1, y1)
+		for (; i + 2 <= count; i += 2) {
+			const __m128 p = _mm_loadu_ps(points + i * 2);
+			const __m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+			const __m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+			const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, colX), _mm_mul_ps(ys, colY)), offset);
+
+			float* v0 = out + i * stride;
+			float* v1 = v0 + stride;
+
+			_mm_storel_pi((__m64*)v0, r);
+			_mm_storeu_ps(v0 + 2, tail);
+			v0[6] = color.a;
+
+			_mm_storeh_pi((__m64*)v1, r);
+			_mm_storeu_ps(v1 + 2, tail);
+			v1[6] = color.a;
+		}
+#endif
+
+		for (; i < count; i++) {
+			const float x = points[i * 2], y = points[i * 2 + 1];
+			float* v = out + i * stride;
+
+			v[0] = m[0] * x + m[1] * y + t.x;
+			v[1] = m[2] * x + m[3] * y + t.y;
+			v[2] = z;
+			v[3] = color.r; v[4] = color.g; v[5] = color.b; v[6] = color.a;
+		}
+	}
+}
@@ -0,0 +1,828 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VOI_RASTER_SSE
+#endif
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "utilDefs.h"
+#include "RenderBackend.h"
+#include "JobSystem.h"
+#include "FrameStats.h"
+
+namespace voi {
+	/*draws the solid color batches and the single texture batches of texture.frag on the cpu, for machines
+	where the only gl is a general purpose software one. triangles are set up and binned into screen tiles as
+	they are drawn, then the tiles are rasterized in parallel when the frame ends, or before anything reads or
+	changes what they were drawn with. all of it runs on the job system of the engine. inside a tile triangles
+	keep their order, so the result is the one of drawing them one after another.
+
+	it follows gl where the engine depends on it: window coordinates snapped to 1/256 of a pixel, pixel centers
+	sampled with a top-left rule, 24 bit depth tested with GL_LEQUAL, RGBA8 color, and textures filtered with
+	mipmaps picked by the level of detail of the triangle. the camera is orthographic, so attributes are
+	interpolated without perspective and primitives are only clipped by depth. programs are drawn by the kind
+	they were made with, draws of Other programs are reported and left out, like everything that calls gl itself*/
+	class SoftwareBackend : public RenderBackend {
+	public:
+		// pixels of a side of the tiles triangles are binned into
+		static const i32 TILE = 32;
+		// bits of a pixel window coordinates keep
+		static const i32 SUBPIXEL_BITS = 8;
+
+	private:
+		static const i32 SUBPIXEL = 1 << SUBPIXEL_BITS;
+		// vertices further away are dropped, edge functions of ones closer stay exact in a double
+		static constexpr float GUARD_BAND = 131072.f;
+
+		// interpolated attributes, in order
+		enum Attribute { Z, R, G, B, A, U, V, ATTRIBUTE_COUNT };
+
+		struct Program {
+			ProgramKind kind;
+			// a draw of it was skipped and said so
+			bool warned = false;
+		};
+
+		struct VertexArray {
+			ui32 vertexBuffer = 0;
+			ui32 elementBuffer = 0;
+			std::vector<ui32> attributes;
+			ui32 stride = 0;
+		};
+
+		struct Texture {
+			// RGBA8, level 0 and after a mipmap was asked for every level down to 1x1. rows in the order given
+			std::vector<std::vector<ui32>> levels;
+			std::vector<std::pair<i32, i32>> sizes;
+			// gl defaults
+			GLenum wrap = GL_REPEAT;
+			GLenum minFilter = GL_NEAREST_MIPMAP_LINEAR;
+			GLenum magFilter = GL_LINEAR;
+
+			bool mipmapped() const { return minFilter != GL_NEAREST && minFilter != GL_LINEAR; }
+			/*gl samples incomplete textures as opaque black*/
+			bool complete() const {
+				if (levels.empty()) return false;
+				if (!mipmapped()) return true;
+
+				i32 w = sizes[0].first, h = sizes[0].second;
+				size_t count = 1;
+				while (w > 1 || h > 1) {
+					w = w > 1 ? w / 2 : 1;
+					h = h > 1 ? h / 2 : 1;
+					count++;
+				}
+				return levels.size() == count;
+			}
+		};
+
+		/*how the texture of a triangle is read, its level of detail doesn't change across it*/
+		struct Sampler {
+			// levels read, the second one is blended in by blend
+			const ui32* texels[2];
+			i32 width[2], height[2];
+			float blend;
+			bool linear;
+			bool repeat;
+			// incomplete textures, and draws without one, read opaque black
+			bool black;
+		};
+
+		struct Triangle {
+			// a * x + b * y + c at the center of pixel x, y, the pixel is inside when all three are >= 0. the
+			// values are whole numbers a double holds exactly, so shared edges are neither missed nor drawn twice
+			double a[3], b[3], c[3];
+			i32 minX, minY, maxX, maxY;
+			// attributes at pixel centers are value + dx * (x - originX) + dy * (y - originY)
+			float originX, originY;
+			float value[ATTRIBUTE_COUNT], dx[ATTRIBUTE_COUNT], dy[ATTRIBUTE_COUNT];
+			Sampler sampler;
+			ProgramKind kind;
+			bool blend;
+			bool depthTest;
+			bool valid;
+		};
+
+		/*the four channels of a color, in one register with sse*/
+		struct Channels {
+#ifdef VOI_RASTER_SSE
+			__m128 v;
+#else
+			float v[4];
+#endif
+		};
+
+		// the pool of the engine, shared with Update
+		JobSystem& jobs;
+
+		ui32 nextName = 0;
+		std::unordered_map<ui32, std::vector<ui8>> buffers;
+		std::unordered_map<ui32, VertexArray> arrays;
+		std::unordered_map<ui32, Program> programs;
+		std::unordered_map<ui32, Texture> textures;
+
+		ui32 uniformBuffers[16] = {};
+		ui32 units[32] = {};
+		ui32 program = 0;
+		bool blend = false;
+		bool depthTest = false;
+		Pixel clearValue = { 0.f, 0.f, 0.f, 0.f };
+		i32 viewportX = 0, viewportY = 0, viewportWidth = 0, viewportHeight = 0;
+
+		// RGBA8 and 24 bit depth, rows from the bottom like gl
+		i32 width = 0, height = 0;
+		std::vector<ui32> color;
+		std::vector<ui32> depth;
+
+		i32 tilesX = 0, tilesY = 0;
+		std::vector<Triangle> triangles;
+		std::vector<std::vector<ui32>> bins;
+
+	public:
+		/*jobs has to outlive the backend*/
+		SoftwareBackend(JobSystem& _jobs) : jobs(_jobs) {}
+
+		const char* getName() const override { return "software"; }
+
+		//---buffers---//
+
+		void createBuffers(ui32 count, ui32* names) override {
+			for (ui32 i = 0; i < count; i++) {
+				names[i] = ++nextName;
+				buffers[names[i]];
+			}
+		}
+		void deleteBuffers(ui32 count, const ui32* names) override {
+			for (ui32 i = 0; i < count; i++) buffers.erase(names[i]);
+		}
+
+		// triangles keep their own copy of what they read, so buffers change without waiting for them
+		void bufferData(ui32 buffer, size_t size, const void* data, GLenum /*usage*/) override {
+			std::vector<ui8>& bytes = buffers[buffer];
+			bytes.resize(size);
+			if (data != NULL && size > 0) memcpy(bytes.data(), data, size);
+		}
+		void bufferSubData(ui32 buffer, size_t offset, size_t size, const void* data) override {
+			std::vector<ui8>& bytes = buffers[buffer];
+			if (offset + size > bytes.size()) {
+				throw "Outside of range Exception";
+			}
+			if (size > 0) memcpy(bytes.data() + offset, data, size);
+		}
+		void bindUniformBuffer(ui32 binding, ui32 buffer) override {
+			if (binding < 16) uniformBuffers[binding] = buffer;
+		}
+
+		//---vertex layout---//
+
+		void createVertexArrays(ui32 count, ui32* names) override {
+			for (ui32 i = 0; i < count; i++) {
+				names[i] = ++nextName;
+				arrays[names[i]];
+			}
+		}
+		void deleteVertexArrays(ui32 count, const ui32* names) override {
+			for (ui32 i = 0; i < count; i++) arrays.erase(names[i]);
+		}
+
+		void vertexLayout(ui32 array, ui32 vertexBuffer, ui32 elementBuffer, const std::vector<ui32>& attributes) override {
+			VertexArray& va = arrays[array];
+			va.vertexBuffer = vertexBuffer;
+			va.elementBuffer = elementBuffer;
+			va.attributes = attributes;
+
+			va.stride = 0;
+			for (ui32 size : attributes) va.stride += size;
+		}
+		void enableAttributes(ui32 /*array*/, const std::vector<ui32>& /*attributes*/) override {}
+
+		//---programs---//
+
+		ui32 createProgram(const std::string& /*vertexCode*/, const std::string& /*fragmentCode*/, ProgramKind kind) override {
+			const ui32 name = ++nextName;
+			programs[name] = { kind };
+			return name;
+		}
+		// programs made by gl itself, like transform feedback ones, are taken as they are
+		bool isProgram(ui32 name) override { return name != 0; }
+		void useProgram(ui32 name) override { program = name; }
+
+		//---textures---//
+
+		void createTextures(ui32 count, ui32* names) override {
+			for (ui32 i = 0; i < count; i++) {
+				names[i] = ++nextName;
+				textures[names[i]];
+			}
+		}
+		void deleteTextures(ui32 count, const ui32* names) override {
+			flush();
+			for (ui32 i = 0; i < count; i++) textures.erase(names[i]);
+		}
+
+		void textureSampling(ui32 texture, GLenum wrap, GLenum minFilter, GLenum magFilter) override {
+			flush();
+			Texture& t = textures[texture];
+			t.wrap = wrap;
+			t.minFilter = minFilter;
+			t.magFilter = magFilter;
+		}
+		void textureImage(ui32 texture, i32 w, i32 h, GLenum format, const void* pixels, bool mipmap) override {
+			flush();
+			Texture& t = textures[texture];
+			t.levels.assign(1, std::vector<ui32>((size_t)w * h));
+			t.sizes.assign(1, { w, h });
+
+			const ui8* src = (const ui8*)pixels;
+			ui32* dst = t.levels[0].data();
+			const size_t count = (size_t)w * h;
+
+			// missing channels are filled like gl does, 0 for color and 1 for alpha
+			switch (format) {
+			case GL_RED:
+				for (size_t i = 0; i < count; i++) dst[i] = Pack8(src[i], 0, 0, 255);
+				break;
+			case GL_RG:
+				for (size_t i = 0; i < count; i++) dst[i] = Pack8(src[i * 2], src[i * 2 + 1], 0, 255);
+				break;
+			case GL_RGB:
+				for (size_t i = 0; i < count; i++) dst[i] = Pack8(src[i * 3], src[i * 3 + 1], src[i * 3 + 2], 255);
+				break;
+			case GL_BGR:
+				for (size_t i = 0; i < count; i++) dst[i] = Pack8(src[i * 3 + 2], src[i * 3 + 1], src[i * 3], 255);
+				break;
+			case GL_BGRA:
+				for (size_t i = 0; i < count; i++) dst[i] = Pack8(src[i * 4 + 2], src[i * 4 + 1], src[i * 4], src[i * 4 + 3]);
+				break;
+			default:
+				memcpy(dst, src, count * 4);
+			}
+
+			if (mipmap) makeMipmaps(t);
+		}
+		void bindTexture(ui32 unit, GLenum target, ui32 texture) override {
+			if (unit < 32) units[unit] = target == GL_TEXTURE_2D ? texture : 0;
+		}
+
+		//---drawing---//
+
+		void initState() override { depthTest = true; }
+
+		/*the framebuffer grows to hold the viewport*/
+		void viewport(i32 x, i32 y, i32 w, i32 h) override {
+			viewportX = x;
+			viewportY = y;
+			viewportWidth = w;
+			viewportHeight = h;
+
+			if (x + w > width || y + h > height) resize(std::max(width, x + w), std::max(height, y + h));
+		}
+
+		void clearColor(const Pixel& c) override { clearValue = c; }
+
+		void clear(GLbitfield mask) override {
+			flush();
+
+			const ui32 c = Pack8(ToUnorm(clearValue.r), ToUnorm(clearValue.g), ToUnorm(clearValue.b), ToUnorm(clearValue.a));
+			const bool colorBit = (mask & GL_COLOR_BUFFER_BIT) != 0, depthBit = (mask & GL_DEPTH_BUFFER_BIT) != 0;
+
+			jobs.parallelFor(0, (size_t)height, 16, [&](size_t from, size_t to) {
+				const size_t begin = from * width, end = to * width;
+				if (colorBit) std::fill(color.begin() + begin, color.begin() + end, c);
+				if (depthBit) std::fill(depth.begin() + begin, depth.begin() + end, 0xffffffu);
+			});
+		}
+
+		void setBlend(bool _blend) override { blend = _blend; }
+
+		/*sets up and bins the triangles, they are rasterized by flush*/
+		void drawElements(ui32 array, GLenum mode, ui32 count) override {
+			if (mode != GL_TRIANGLES || count < 3 || width == 0) return;
+
+			// programs made by gl itself come in as Other
+			Program& p = programs.emplace(program, Program{ ProgramKind::Other }).first->second;
+			if (p.kind == ProgramKind::Other) {
+				if (!p.warned) {
+					std::cout << "ERROR::SOFTWARE::PROGRAM_NOT_SUPPORTED " << program << ", its draws are skipped" << std::endl;
+					p.warned = true;
+				}
+				return;
+			}
+			const ProgramKind kind = p.kind;
+
+			auto va = arrays.find(array);
+			if (va == arrays.end()) return;
+			const VertexArray& layout = va->second;
+
+			// position, color and, for textures, texture coordinates first
+			const ui32 needed = kind == ProgramKind::Texture ? 3 : 2;
+			const ui32 sizes[3] = { 3, 4, 2 };
+			if (layout.attributes.size() < needed) return;
+			for (ui32 i = 0; i < needed; i++) {
+				if (layout.attributes[i] < sizes[i]) return;
+			}
+
+			const std::vector<ui8>& vertexBytes = buffers[layout.vertexBuffer];
+			const std::vector<ui8>& elementBytes = buffers[layout.elementBuffer];
+			if ((size_t)count * sizeof(ui32) > elementBytes.size()) {
+				throw "Outside of range Exception";
+			}
+
+			const Texture* texture = nullptr;
+			if (kind == ProgramKind::Texture) {
+				auto t = textures.find(units[0]);
+				if (t != textures.end()) texture = &t->second;
+			}
+
+			float viewProj[16] = { 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f };
+			const std::vector<ui8>& camera = buffers[uniformBuffers[0]];
+			if (camera.size() >= sizeof(viewProj)) memcpy(viewProj, camera.data(), sizeof(viewProj));
+
+			const float* vertices = (const float*)vertexBytes.data();
+			const ui32* elements = (const ui32*)elementBytes.data();
+			const size_t vertexCount = layout.stride > 0 ? vertexBytes.size() / (layout.stride * sizeof(float)) : 0;
+
+			const size_t first = triangles.size();
+			const size_t n = count / 3;
+			triangles.resize(first + n);
+
+			jobs.parallelFor(0, n, 1024, [&](size_t from, size_t to) {
+				for (size_t i = from; i < to; i++) {
+					Triangle& t = triangles[first + i];
+					t.valid = false;
+
+					const float* v[3];
+					for (ui32 k = 0; k < 3; k++) {
+						const ui32 e = elements[i * 3 + k];
+						if (e >= vertexCount) break;
+						v[k] = vertices + (size_t)e * layout.stride;
+						if (k == 2) t.valid = true;
+					}
+					if (!t.valid) continue;
+
+					t.kind = kind;
+					t.blend = blend;
+					t.depthTest = depthTest;
+					setup(t, v, layout.attributes, viewProj, texture);
+				}
+			});
+
+			// every job bins into its own rows of tiles, going over the triangles in order so every tile draws
+			// them in the order they came. small draws are binned on the calling thread
+			const size_t rowsPerJob = n < 1024 ? (size_t)tilesY : 1;
+			jobs.parallelFor(0, (size_t)tilesY, rowsPerJob, [&](size_t from, size_t to) {
+				for (size_t i = first; i < triangles.size(); i++) {
+					const Triangle& t = triangles[i];
+					if (!t.valid) continue;
+
+					const i32 minRow = std::max(t.minY / TILE, (i32)from), maxRow = std::min(t.maxY / TILE, (i32)to - 1);
+					for (i32 ty = minRow; ty <= maxRow; ty++) {
+						for (i32 tx = t.minX / TILE; tx <= t.maxX / TILE; tx++) {
+							bins[(size_t)ty * tilesX + tx].push_back((ui32)i);
+						}
+					}
+				}
+			});
+		}
+
+		void finishFrame() override { flush(); }
+
+		void readPixels(ui32 w, ui32 h, std::vector<ui8>& rgba) override {
+			flush();
+
+			const size_t row = (size_t)w * 4;
+			rgba.assign(row * h, 0);
+
+			// rows from the top like image files
+			for (ui32 y = 0; y < h && (i32)y < height; y++) {
+				const ui32 copied = (i32)w < width ? w : (ui32)width;
+				memcpy(rgba.data() + (h - 1 - y) * row, color.data() + (size_t)y * width, copied * 4);
+			}
+
+			DrawCounters().otherBytes += row * h;
+		}
+
+		/*rasterizes every tile with triangles binned since the last flush*/
+		void flush() {
+			if (triangles.empty()) return;
+
+			jobs.parallelFor(0, bins.size(), 1, [this](size_t from, size_t to) {
+				for (size_t tile = from; tile < to; tile++) {
+					if (!bins[tile].empty()) rasterizeTile((i32)tile);
+				}
+			});
+
+			triangles.clear();
+			for (auto& bin : bins) bin.clear();
+		}
+
+	private:
+		static ui32 Pack8(ui32 r, ui32 g, ui32 b, ui32 a) { return r | (g << 8) | (b << 16) | (a << 24); }
+
+		static ui32 ToUnorm(float c) {
+			c = c < 0.f ? 0.f : (c > 1.f ? 1.f : c);
+			return (ui32)(c * 255.f + 0.5f);
+		}
+
+		void resize(i32 w, i32 h) {
+			flush();
+
+			std::vector<ui32> newColor((size_t)w * h, 0), newDepth((size_t)w * h, 0xffffffu);
+			for (i32 y = 0; y < height; y++) {
+				memcpy(newColor.data() + (size_t)y * w, color.data() + (size_t)y * width, width * sizeof(ui32));
+				memcpy(newDepth.data() + (size_t)y * w, depth.data() + (size_t)y * width, width * sizeof(ui32));
+			}
+			color.swap(newColor);
+			depth.swap(newDepth);
+
+			width = w;
+			height = h;
+			tilesX = (w + TILE - 1) / TILE;
+			tilesY = (h + TILE - 1) / TILE;
+			bins.assign((size_t)tilesX * tilesY, {});
+		}
+
+		/*every level halves the one before with a box filter, down to 1x1*/
+		static void makeMipmaps(Texture& t) {
+			t.levels.resize(1);
+			t.sizes.resize(1);
+
+			while (t.sizes.back().first > 1 || t.sizes.back().second > 1) {
+				const i32 pw = t.sizes.back().first, ph = t.sizes.back().second;
+				const i32 w = pw > 1 ? pw / 2 : 1, h = ph > 1 ? ph / 2 : 1;
+
+				std::vector<ui32> level((size_t)w * h);
+				const std::vector<ui32>& previous = t.levels.back();
+
+				for (i32 y = 0; y < h; y++) {
+					const i32 y0 = y * 2 < ph ? y * 2 : ph - 1, y1 = y * 2 + 1 < ph ? y * 2 + 1 : ph - 1;
+					for (i32 x = 0; x < w; x++) {
+						const i32 x0 = x * 2 < pw ? x * 2 : pw - 1, x1 = x * 2 + 1 < pw ? x * 2 + 1 : pw - 1;
+						const ui32 texels[4] = {
+							previous[(size_t)y0 * pw + x0], previous[(size_t)y0 * pw + x1],
+							previous[(size_t)y1 * pw + x0], previous[(size_t)y1 * pw + x1]
+						};
+
+						// red and blue, then green and alpha, summed two channels at a time in 16 bits each
+						ui32 even = 0x00020002u, odd = 0x00020002u;
+						for (ui32 texel : texels) {
+							even += texel & 0x00ff00ffu;
+							odd += (texel >> 8) & 0x00ff00ffu;
+						}
+						level[(size_t)y * w + x] = ((even >> 2) & 0x00ff00ffu) | (((odd >> 2) & 0x00ff00ffu) << 8);
+					}
+				}
+
+				t.levels.push_back(std::move(level));
+				t.sizes.push_back({ w, h });
+			}
+		}
+
+		/*window coordinates, edge functions and attribute planes of one triangle*/
+		void setup(Triangle& t, const float* v[3], const std::vector<ui32>& attributes, const float m[16], const Texture* texture) const {
+			float wx[3], wy[3], attr[3][ATTRIBUTE_COUNT];
+			i64 sx[3], sy[3];
+
+			const ui32 colorOffset = attributes[0];
+			const ui32 uvOffset = colorOffset + attributes[1];
+
+			for (ui32 k = 0; k < 3; k++) {
+				const float x = v[k][0], y = v[k][1], z = v[k][2];
+
+				// column major like the uniform block
+				const float cx = m[0] * x + m[4] * y + m[8] * z + m[12];
+				const float cy = m[1] * x + m[5] * y + m[9] * z + m[13];
+				const float cz = m[2] * x + m[6] * y + m[10] * z + m[14];
+				const float cw = m[3] * x + m[7] * y + m[11] * z + m[15];
+				if (cw <= 0.f) {
+					t.valid = false;
+					return;
+				}
+
+				wx[k] = viewportX + (cx / cw + 1.f) * 0.5f * viewportWidth;
+				wy[k] = viewportY + (cy / cw + 1.f) * 0.5f * viewportHeight;
+				if (!(fabsf(wx[k]) < GUARD_BAND && fabsf(wy[k]) < GUARD_BAND)) {
+					t.valid = false;
+					return;
+				}
+				sx[k] = (i64)llrintf(wx[k] * SUBPIXEL);
+				sy[k] = (i64)llrintf(wy[k] * SUBPIXEL);
+
+				attr[k][Z] = cz / cw;
+				for (ui32 c = 0; c < 4; c++) attr[k][R + c] = v[k][colorOffset + c];
+				attr[k][U] = t.kind == ProgramKind::Texture ? v[k][uvOffset] : 0.f;
+				attr[k][V] = t.kind == ProgramKind::Texture ? v[k][uvOffset + 1] : 0.f;
+			}
+
+			// counter clockwise, nothing is culled
+			i64 area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+			if (area == 0) {
+				t.valid = false;
+				return;
+			}
+			if (area < 0) {
+				std::swap(sx[1], sx[2]);
+				std::swap(sy[1], sy[2]);
+				std::swap(wx[1], wx[2]);
+				std::swap(wy[1], wy[2]);
+				std::swap(attr[1], attr[2]);
+			}
+
+			// pixels whose centers are inside the bounds, within the viewport
+			const i64 half = SUBPIXEL / 2;
+			const i64 minSX = std::min({ sx[0], sx[1], sx[2] }), maxSX = std::max({ sx[0], sx[1], sx[2] });
+			const i64 minSY = std::min({ sy[0], sy[1], sy[2] }), maxSY = std::max({ sy[0], sy[1], sy[2] });
+
+			t.minX = (i32)std::max<i64>(CeilDiv(minSX - half, SUBPIXEL), std::max(viewportX, 0));
+			t.minY = (i32)std::max<i64>(CeilDiv(minSY - half, SUBPIXEL), std::max(viewportY, 0));
+			t.maxX = (i32)std::min<i64>(FloorDiv(maxSX - half, SUBPIXEL), std::min(viewportX + viewportWidth, width) - 1);
+			t.maxY = (i32)std::min<i64>(FloorDiv(maxSY - half, SUBPIXEL), std::min(viewportY + viewportHeight, height) - 1);
+			if (t.minX > t.maxX || t.minY > t.maxY) {
+				t.valid = false;
+				return;
+			}
+
+			for (ui32 e = 0; e < 3; e++) {
+				const ui32 j = e, k = (e + 1) % 3;
+				const i64 a = sy[j] - sy[k], b = sx[k] - sx[j];
+				i64 c = sx[j] * sy[k] - sx[k] * sy[j];
+
+				// evaluated at pixel centers, from pixel indices
+				c += a * half + b * half;
+				// centers right on an edge are inside only when it is a left or a bottom one, the top-left rule
+				// with rows counted from the bottom like gl does
+				if (!(a > 0 || (a == 0 && b > 0))) c -= 1;
+
+				t.a[e] = (double)(a * SUBPIXEL);
+				t.b[e] = (double)(b * SUBPIXEL);
+				t.c[e] = (double)c;
+			}
+
+			// planes from the unsnapped positions, gl interpolates between those too
+			const double x1 = wx[1] - wx[0], y1 = wy[1] - wy[0];
+			const double x2 = wx[2] - wx[0], y2 = wy[2] - wy[0];
+			const double d = x1 * y2 - x2 * y1;
+
+			t.originX = wx[0];
+			t.originY = wy[0];
+			for (ui32 i = 0; i < ATTRIBUTE_COUNT; i++) {
+				const double a1 = attr[1][i] - attr[0][i], a2 = attr[2][i] - attr[0][i];
+				t.value[i] = attr[0][i];
+				t.dx[i] = d != 0.0 ? (float)((a1 * y2 - a2 * y1) / d) : 0.f;
+				t.dy[i] = d != 0.0 ? (float)((a2 * x1 - a1 * x2) / d) : 0.f;
+			}
+
+			// log2 of texels per pixel
+			float lod = 0.f;
+			if (t.kind == ProgramKind::Texture && texture != nullptr && !texture->sizes.empty()) {
+				const float tw = (float)texture->sizes[0].first, th = (float)texture->sizes[0].second;
+				const float rx = sqrtf(t.dx[U] * tw * t.dx[U] * tw + t.dx[V] * th * t.dx[V] * th);
+				const float ry = sqrtf(t.dy[U] * tw * t.dy[U] * tw + t.dy[V] * th * t.dy[V] * th);
+				const float rho = rx > ry ? rx : ry;
+				lod = rho > 0.f ? log2f(rho) : -1000.f;
+			}
+			t.sampler = Sampling(texture, lod);
+		}
+
+		static i64 FloorDiv(i64 a, i64 b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+		static i64 CeilDiv(i64 a, i64 b) { return -FloorDiv(-a, b); }
+
+		void rasterizeTile(i32 tile) {
+			const i32 tileX = (tile % tilesX) * TILE, tileY = (tile / tilesX) * TILE;
+
+			for (ui32 index : bins[tile]) {
+				const Triangle& t = triangles[index];
+
+				const i32 x0 = std::max(tileX, t.minX), x1 = std::min(tileX + TILE - 1, t.maxX);
+				const i32 y0 = std::max(tileY, t.minY), y1 = std::min(tileY + TILE - 1, t.maxY);
+
+				for (i32 y = y0; y <= y1; y++) {
+					for (i32 x = x0; x <= x1; x += 4) {
+						ui32 mask = coverage(t, x, y);
+						// lanes past the triangle or the tile
+						if (x1 - x < 3) mask &= (1u << (x1 - x + 1)) - 1;
+						if (mask != 0) shade(t, x, y, mask);
+					}
+				}
+			}
+		}
+
+		/*bit i set when the center of pixel x + i, y is inside*/
+		static ui32 coverage(const Triangle& t, i32 x, i32 y) {
+#ifdef VOI_RASTER_SSE
+			__m128d lo = _mm_castsi128_pd(_mm_set1_epi32(-1)), hi = lo;
+			const __m128d zero = _mm_setzero_pd();
+
+			for (ui32 e = 0; e < 3; e++) {
+				const double base = t.a[e] * x + t.b[e] * y + t.c[e];
+				const __m128d eLo = _mm_add_pd(_mm_set1_pd(base), _mm_set_pd(t.a[e], 0.0));
+				const __m128d eHi = _mm_add_pd(_mm_set1_pd(base), _mm_set_pd(t.a[e] * 3.0, t.a[e] * 2.0));
+				lo = _mm_and_pd(lo, _mm_cmpge_pd(eLo, zero));
+				hi = _mm_and_pd(hi, _mm_cmpge_pd(eHi, zero));
+			}
+			return (ui32)(_mm_movemask_pd(lo) | (_mm_movemask_pd(hi) << 2));
+#else
+			ui32 mask = 0;
+			for (ui32 lane = 0; lane < 4; lane++) {
+				bool inside = true;
+				for (ui32 e = 0; e < 3; e++) inside = inside && t.a[e] * (x + lane) + t.b[e] * y + t.c[e] >= 0.0;
+				mask |= inside ? 1u << lane : 0u;
+			}
+			return mask;
+#endif
+		}
+
+		/*depth test, color and write of the covered pixels of x .. x + 3, y*/
+		void shade(const Triangle& t, i32 x, i32 y, ui32 mask) {
+			// attributes of the four pixels
+			float lanes[ATTRIBUTE_COUNT][4];
+			const float fx = x + 0.5f - t.originX, fy = y + 0.5f - t.originY;
+			const ui32 count = t.kind == ProgramKind::Texture ? ATTRIBUTE_COUNT : A + 1;
+#ifdef VOI_RASTER_SSE
+			const __m128 steps = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+			for (ui32 i = 0; i < count; i++) {
+				const __m128 base = _mm_set1_ps(t.value[i] + t.dx[i] * fx + t.dy[i] * fy);
+				_mm_storeu_ps(lanes[i], _mm_add_ps(base, _mm_mul_ps(steps, _mm_set1_ps(t.dx[i]))));
+			}
+#else
+			for (ui32 i = 0; i < count; i++) {
+				const float base = t.value[i] + t.dx[i] * fx + t.dy[i] * fy;
+				for (ui32 lane = 0; lane < 4; lane++) lanes[i][lane] = base + t.dx[i] * lane;
+			}
+#endif
+
+			const size_t row = (size_t)y * width;
+			for (ui32 lane = 0; lane < 4; lane++) {
+				if ((mask & (1u << lane)) == 0) continue;
+
+				// primitives are clipped to the depth range
+				const float z = lanes[Z][lane];
+				if (z < -1.f || z > 1.f) continue;
+
+				const ui32 d = (ui32)((z * 0.5f + 0.5f) * 16777215.f + 0.5f);
+				ui32& stored = depth[row + x + lane];
+				if (t.depthTest && d > stored) continue;
+
+				Channels c = Set(lanes[R][lane], lanes[G][lane], lanes[B][lane], lanes[A][lane]);
+				if (t.kind == ProgramKind::Texture) {
+					// mix(texture, vec4(color.rgb, 1.0), color.a)
+					const Channels texel = Sample(t.sampler, lanes[U][lane], lanes[V][lane]);
+					c = Lerp(texel, Set(lanes[R][lane], lanes[G][lane], lanes[B][lane], 1.f), lanes[A][lane]);
+				}
+
+				ui32& pixel = color[row + x + lane];
+				if (t.blend) c = Lerp(Unpack(pixel, 1.f / 255.f), c, Alpha(c));
+				pixel = Pack(c);
+				if (t.depthTest) stored = d;
+			}
+		}
+
+		//---texture sampling---//
+
+		/*the levels and filter gl picks for lod*/
+		static Sampler Sampling(const Texture* texture, float lod) {
+			Sampler s = {};
+			if (texture == nullptr || !texture->complete()) {
+				s.black = true;
+				return s;
+			}
+			const Texture& t = *texture;
+
+			const GLenum filter = lod > 0.f ? t.minFilter : t.magFilter;
+			const i32 last = (i32)t.levels.size() - 1;
+			i32 l0 = 0, l1 = 0;
+
+			switch (filter) {
+			case GL_NEAREST_MIPMAP_NEAREST:
+			case GL_LINEAR_MIPMAP_NEAREST:
+				l0 = l1 = NearestLevel(lod, last);
+				break;
+			case GL_NEAREST_MIPMAP_LINEAR:
+			case GL_LINEAR_MIPMAP_LINEAR: {
+				const float level = lod > (float)last ? (float)last : lod;
+				l0 = (i32)level;
+				l1 = l0 < last ? l0 + 1 : l0;
+				s.blend = level - l0;
+				break;
+			}
+			}
+
+			const i32 levels[2] = { l0, l1 };
+			for (ui32 i = 0; i < 2; i++) {
+				s.texels[i] = t.levels[levels[i]].data();
+				s.width[i] = t.sizes[levels[i]].first;
+				s.height[i] = t.sizes[levels[i]].second;
+			}
+			s.linear = filter == GL_LINEAR || filter == GL_LINEAR_MIPMAP_NEAREST || filter == GL_LINEAR_MIPMAP_LINEAR;
+			s.repeat = t.wrap != GL_CLAMP_TO_EDGE;
+			return s;
+		}
+
+		static i32 NearestLevel(float lod, i32 last) {
+			const i32 l = lod <= 0.5f ? 0 : (i32)ceilf(lod + 0.5f) - 1;
+			return l < last ? l : last;
+		}
+
+		static Channels Sample(const Sampler& s, float u, float v) {
+			if (s.black) return Set(0.f, 0.f, 0.f, 1.f);
+
+			const Channels c = s.linear ? Bilinear(s, 0, u, v) : Nearest(s, 0, u, v);
+			if (s.blend <= 0.f) return c;
+			return Lerp(c, s.linear ? Bilinear(s, 1, u, v) : Nearest(s, 1, u, v), s.blend);
+		}
+
+		static i32 Wrap(i32 i, i32 size, bool repeat) {
+			if ((ui32)i < (ui32)size) return i;
+			if (!repeat) return i < 0 ? 0 : size - 1;
+			i %= size;
+			return i < 0 ? i + size : i;
+		}
+
+		// floorf is a call without sse4.1
+		static i32 Floor(float x) {
+			const i32 i = (i32)x;
+			return x < (float)i ? i - 1 : i;
+		}
+
+		static Channels Nearest(const Sampler& s, ui32 level, float u, float v) {
+			const i32 w = s.width[level], h = s.height[level];
+			const i32 x = Wrap(Floor(u * w), w, s.repeat), y = Wrap(Floor(v * h), h, s.repeat);
+			return Unpack(s.texels[level][(size_t)y * w + x], 1.f / 255.f);
+		}
+
+		static Channels Bilinear(const Sampler& s, ui32 level, float u, float v) {
+			const i32 w = s.width[level], h = s.height[level];
+			const float tx = u * w - 0.5f, ty = v * h - 0.5f;
+			const i32 fx = Floor(tx), fy = Floor(ty);
+			const float ax = tx - fx, ay = ty - fy;
+
+			const i32 x0 = Wrap(fx, w, s.repeat), x1 = Wrap(fx + 1, w, s.repeat);
+			const i32 y0 = Wrap(fy, h, s.repeat), y1 = Wrap(fy + 1, h, s.repeat);
+			const ui32* bottom = s.texels[level] + (size_t)y0 * w;
+			const ui32* top = s.texels[level] + (size_t)y1 * w;
+
+			// scaled to 0 .. 1 once, after the texels are blended
+			const Channels c = Lerp(Lerp(Unpack(bottom[x0], 1.f), Unpack(bottom[x1], 1.f), ax), Lerp(Unpack(top[x0], 1.f), Unpack(top[x1], 1.f), ax), ay);
+			return Scale(c, 1.f / 255.f);
+		}
+
+		//---channels---//
+
+#ifdef VOI_RASTER_SSE
+		static Channels Set(float r, float g, float b, float a) { return { _mm_set_ps(a, b, g, r) }; }
+
+		static Channels Unpack(ui32 c, float scale) {
+			const __m128i bytes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)c), _mm_setzero_si128()), _mm_setzero_si128());
+			return { _mm_mul_ps(_mm_cvtepi32_ps(bytes), _mm_set1_ps(scale)) };
+		}
+
+		static ui32 Pack(const Channels& c) {
+			const __m128 clamped = _mm_min_ps(_mm_max_ps(c.v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+			// truncated after adding a half, like ToUnorm
+			const __m128i words = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.f)), _mm_set1_ps(0.5f)));
+			const __m128i shorts = _mm_packs_epi32(words, words);
+			return (ui32)_mm_cvtsi128_si32(_mm_packus_epi16(shorts, shorts));
+		}
+
+		static Channels Lerp(const Channels& a, const Channels& b, float t) {
+			return { _mm_add_ps(a.v, _mm_mul_ps(_mm_sub_ps(b.v, a.v), _mm_set1_ps(t))) };
+		}
+
+		static Channels Scale(const Channels& c, float scale) { return { _mm_mul_ps(c.v, _mm_set1_ps(scale)) }; }
+
+		static float Alpha(const Channels& c) { return _mm_cvtss_f32(_mm_shuffle_ps(c.v, c.v, _MM_SHUFFLE(3, 3, 3, 3))); }
+#else
+		static Channels Set(float r, float g, float b, float a) { return { { r, g, b, a } }; }
+
+		static Channels Unpack(ui32 c, float scale) {
+			return { { (c & 0xff) * scale, ((c >> 8) & 0xff) * scale, ((c >> 16) & 0xff) * scale, (c >> 24) * scale } };
+		}
+
+		static ui32 Pack(const Channels& c) { return Pack8(ToUnorm(c.v[0]), ToUnorm(c.v[1]), ToUnorm(c.v[2]), ToUnorm(c.v[3])); }
+
+		static Channels Lerp(const Channels& a, const Channels& b, float t) {
+			Channels c;
+			for (ui32 i = 0; i < 4; i++) c.v[i] = a.v[i] + (b.v[i] - a.v[i]) * t;
+			return c;
+		}
+
+		static Channels Scale(const Channels& c, float scale) {
+			Channels s;
+			for (ui32 i = 0; i < 4; i++) s.v[i] = c.v[i] * scale;
+			return s;
+		}
+
+		static float Alpha(const Channels& c) { return c.v[3]; }
+#endif
+	};
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "JobSystem.h"
+
+namespace voi {
+	/*uniform grid over world space boxes. every object is stored in the single cell that holds the center of
+	its box, and queries grow the searched area by the largest half extent in the grid to make up for it.
+	cells are contiguous ranges of one flat item array, objects that change cell after a build wait in a
+	small overflow list until enough of them pile up to rebuild the whole grid*/
+	class SpatialGrid {
+		static constexpr ui32 NONE = 0xffffffff;
+		static constexpr ui32 IN_OVERFLOW = 0xfffffffe;
+
+		Vec2f origin;
+		float cellSize;
+		float invCellSize;
+		ui32 cols, rows;
+
+		// per object, indexed by handle
+		std::vector<AABB2f> boxes;
+		std::vector<ui32> objectCell;
+		std::vector<ui32> objectSlot;
+		std::vector<ui32> freeHandles;
+
+		// items[cellStart[c] .. cellStart[c + 1]] are the objects of cell c, removed ones are NONE
+		std::vector<ui32> cellStart;
+		std::vector<ui32> items;
+		std::vector<ui32> overflow;
+
+		Vec2f maxHalfExtent;
+		ui32 liveCount = 0;
+		ui32 deadItems = 0;
+
+	public:
+		SpatialGrid(const AABB2f& bounds, float _cellSize) :
+			origin(bounds.min), cellSize(_cellSize), invCellSize(1.f / _cellSize) {
+
+			cols = (ui32)ceilf((bounds.max.x - bounds.min.x) * invCellSize);
+			rows = (ui32)ceilf((bounds.max.y - bounds.min.y) * invCellSize);
+			cols = cols > 0 ? cols : 1;
+			rows = rows > 0 ? rows : 1;
+
+			cellStart.assign(cols * rows + 1, 0);
+		}
+
+		ui32 size() const { return liveCount; }
+		const AABB2f& getBox(ui32 id) const { return boxes[id]; }
+
+		/*replaces the content of the grid, object i gets handle i*/
+		void build(const std::vector<AABB2f>& newBoxes) {
+			boxes = newBoxes;
+			objectCell.assign(boxes.size(), IN_OVERFLOW);
+			objectSlot.assign(boxes.size(), NONE);
+			freeHandles.clear();
+			liveCount = (ui32)boxes.size();
+
+			rebuild();
+		}
+
+		ui32 insert(const AABB2f& box) {
+			ui32 id;
+			if (!freeHandles.empty()) {
+				id = freeHandles.back();
+				freeHandles.pop_back();
+				boxes[id] = box;
+			}
+			else {
+				id = (ui32)boxes.size();
+				boxes.push_back(box);
+				objectCell.push_back(NONE);
+				objectSlot.push_back(NONE);
+			}
+
+			liveCount++;
+			growExtent(box);
+			pushOverflow(id);
+
+			return id;
+		}
+
+		void update(ui32 id, const AABB2f& box) {
+			if (id >= boxes.size() || objectCell[id] == NONE) {
+				throw "Outside of range Exception";
+			}
+
+			boxes[id] = box;
+			growExtent(box);
+
+			const ui32 cell = objectCell[id];
+			if (cell == IN_OVERFLOW || cell == cellOf(box)) return;
+
+			items[objectSlot[id]] = NONE;
+			deadItems++;
+			pushOverflow(id);
+		}
+
+		void remove(ui32 id) {
+			if (id >= boxes.size() || objectCell[id] == NONE) {
+				throw "Outside of range Exception";
+			}
+
+			if (objectCell[id] == IN_OVERFLOW) {
+				const ui32 slot = objectSlot[id];
+				overflow[slot] = overflow.back();
+				objectSlot[overflow[slot]] = slot;
+				overflow.pop_back();
+			}
+			else {
+				items[objectSlot[id]] = NONE;
+				deadItems++;
+			}
+
+			objectCell[id] = NONE;
+			objectSlot[id] = NONE;
+			freeHandles.push_back(id);
+			liveCount--;
+		}
+
+		/*appends the handle of every object overlapping rect, returns how many were added*/
+		size_t query(const AABB2f& rect, std::vector<ui32>& out) const {
+			const size_t before = out.size();
+
+			ui32 x0, y0, x1, y1;
+			cellRange(rect, x0, y0, x1, y1);
+
+			queryRows(rect, x0, x1, y0, y1, out);
+			queryOverflow(rect, out);
+
+			return out.size() - before;
+		}
+
+		size_t queryPoint(Vec2f p, std::vector<ui32>& out) const {
+			return query({ p, p }, out);
+		}
+
+		/*same result and order as query, rows of cells are split between the jobs of the pool*/
+		size_t queryParallel(const AABB2f& rect, std::vector<ui32>& out, JobSystem& jobs) const {
+			const size_t before = out.size();
+
+			ui32 x0, y0, x1, y1;
+			cellRange(rect, x0, y0, x1, y1);
+
+			const ui32 rowCount = y1 - y0 + 1;
+			ui32 parts = jobs.getWorkerCount() + 1;
+			parts = parts < rowCount ? parts : rowCount;
+
+			if (parts <= 1 || (size_t)rowCount * (x1 - x0 + 1) < 1024) {
+				return query(rect, out);
+			}
+
+			// the first part goes straight into out, the rest is appended after it in order
+			std::vector<std::vector<ui32>> partial(parts);
+			jobs.parallelFor(0, parts, 1, [&](size_t from, size_t to) {
+				for (size_t p = from; p < to; p++) {
+					queryRows(rect, x0, x1, y0 + rowCount * (ui32)p / parts, y0 + rowCount * ((ui32)p + 1) / parts - 1, p == 0 ? out : partial[p]);
+				}
+			});
+
+			for (ui32 p = 1; p < parts; p++) {
+				out.insert(out.end(), partial[p].begin(), partial[p].end());
+			}
+
+			queryOverflow(rect, out);
+
+			return out.size() - before;
+		}
+
+	private:
+		ui32 cellOf(const AABB2f& box) const {
+			const float cx = (box.min.x + box.max.x) * 0.5f, cy = (box.min.y + box.max.y) * 0.5f;
+			return clampCol((cx - origin.x) * invCellSize) + clampRow((cy - origin.y) * invCellSize) * cols;
+		}
+		ui32 clampCol(float x) const {
+			if (!(x > 0.f)) return 0;
+			return x >= (float)cols ? cols - 1 : (ui32)x;
+		}
+		ui32 clampRow(float y) const {
+			if (!(y > 0.f)) return 0;
+			return y >= (float)rows ? rows - 1 : (ui32)y;
+		}
+
+		void cellRange(const AABB2f& rect, ui32& x0, ui32& y0, ui32& x1, ui32& y1) const {
+			x0 = clampCol((rect.min.x - maxHalfExtent.x - origin.x) * invCellSize);
+			y0 = clampRow((rect.min.y - maxHalfExtent.y - origin.y) * invCellSize);
+			x1 = clampCol((rect.max.x + maxHalfExtent.x - origin.x) * invCellSize);
+			y1 = clampRow((rect.max.y + maxHalfExtent.y - origin.y) * invCellSize);
+		}
+
+		void queryRows(const AABB2f& rect, ui32 x0, ui32 x1, ui32 y0, ui32 y1, std::vector<ui32>& out) const {
+			for (ui32 y = y0; y <= y1 && y < rows; y++) {
+				// the cells of a row are consecutive, so is their part of items
+				const ui32 begin = cellStart[y * cols + x0], end = cellStart[y * cols + x1 + 1];
+
+				for (ui32 i = begin; i < end; i++) {
+					const ui32 id = items[i];
+					if (id != NONE && boxes[id].overlaps(rect)) out.push_back(id);
+				}
+			}
+		}
+		void queryOverflow(const AABB2f& rect, std::vector<ui32>& out) const {
+			for (ui32 id : overflow) {
+				if (boxes[id].overlaps(rect)) out.push_back(id);
+			}
+		}
+
+		void growExtent(const AABB2f& box) {
+			const float hx = (box.max.x - box.min.x) * 0.5f, hy = (box.max.y - box.min.y) * 0.5f;
+			maxHalfExtent.x = hx > maxHalfExtent.x ? hx : maxHalfExtent.x;
+			maxHalfExtent.y = hy > maxHalfExtent.y ? hy : maxHalfExtent.y;
+		}
+
+		void pushOverflow(ui32 id) {
+			objectCell[id] = IN_OVERFLOW;
+			objectSlot[id] = (ui32)overflow.size();
+			overflow.push_back(id);
+
+			if (overflow.size() + deadItems > 64 + liveCount / 8) rebuild();
+		}
+
+		/*counting sort of every live object by cell*/
+		void rebuild() {
+			cellStart.assign(cols * rows + 1, 0);
+			maxHalfExtent = { 0.f, 0.f };
+
+			for (ui32 id = 0; id < boxes.size(); id++) {
+				if (objectCell[id] == NONE) continue;
+
+				const ui32 cell = cellOf(boxes[id]);
+				objectCell[id] = cell;
+				cellStart[cell + 1]++;
+				growExtent(boxes[id]);
+			}
+			for (ui32 c = 0; c < cols * rows; c++) cellStart[c + 1] += cellStart[c];
+
+			items.assign(cellStart.back(), NONE);
+			std::vector<ui32> cursor(cellStart.begin(), cellStart.end() - 1);
+
+			for (ui32 id = 0; id < boxes.size(); id++) {
+				const ui32 cell = objectCell[id];
+				if (cell == NONE) continue;
+
+				objectSlot[id] = cursor[cell];
+				items[cursor[cell]++] = id;
+			}
+
+			overflow.clear();
+			deadItems = 0;
+		}
+	};
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <utility>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Shader.h"
+
+namespace voi {
+	/*grid of tiles from one tileset texture, split in square chunks with their own static vertex buffer.
+	a chunk is only built once it is first seen and rebuilt when one of its tiles changes, so drawing a
+	static map costs one draw call per visible chunk and no upload at all*/
+	class Tilemap {
+		// x, y, u, v
+		static constexpr ui32 VERTEX_FLOATS = 4;
+
+		struct Chunk {
+			// gpu side, only touched by the thread that draws
+			ui32 vao = 0;
+			ui32 vbo = 0;
+
+			ui32 quadCount = 0;
+			bool dirty = true;
+		};
+
+	public:
+		/*chunks to draw in one frame and the vertices of the ones rebuilt for it, prepare fills it and draw
+		only reads it, so both can run on different threads*/
+		struct Data {
+			struct Build {
+				ui32 chunk;
+				std::vector<float> vertices;
+			};
+			// builds past buildCount are kept for their memory
+			std::vector<Build> builds;
+			size_t buildCount = 0;
+
+			// chunk index and quad count
+			std::vector<std::pair<ui32, ui32>> visible;
+			float z = 0.f;
+		};
+
+	private:
+
+		ui32 width, height;
+		ui32 chunkSize;
+		ui32 chunkCols, chunkRows;
+
+		float tileSize;
+		Vec2f origin;
+		float z = 0.f;
+
+		std::vector<ui32> tiles;
+		std::vector<Chunk> chunks;
+
+		Shader program;
+		ui32 texture;
+		ui32 tilesetCols, tilesetRows;
+		Vec2f uvInset;
+
+		// indices of a full chunk, shared by every chunk
+		ui32 ebo = 0;
+
+		ui32 drawnChunks = 0;
+		Data frame;
+
+	public:
+		static constexpr ui32 EMPTY = 0xffffffff;
+
+		/*tileset is a texture of tilesetCols * tilesetRows tiles, tile ids go row by row from its top left*/
+		Tilemap(ui32 _width, ui32 _height, float _tileSize, ui32 programId, ui32 tileset, ui32 _tilesetCols, ui32 _tilesetRows,
+			ui32 _chunkSize = 32) :
+			width(_width), height(_height), chunkSize(_chunkSize), tileSize(_tileSize),
+			program(programId), texture(tileset), tilesetCols(_tilesetCols), tilesetRows(_tilesetRows) {
+
+			chunkCols = (width + chunkSize - 1) / chunkSize;
+			chunkRows = (height + chunkSize - 1) / chunkSize;
+
+			tiles.assign((size_t)width * height, EMPTY);
+			chunks.resize((size_t)chunkCols * chunkRows);
+
+			// half a texel in, so filtering never samples the neighbouring tile of the tileset
+			GLint texW = 0, texH = 0;
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &texW);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &texH);
+			uvInset = { texW > 0 ? 0.5f / texW : 0.f, texH > 0 ? 0.5f / texH : 0.f };
+
+			std::vector<ui32> elements((size_t)chunkSize * chunkSize * 6);
+			for (ui32 q = 0; q < chunkSize * chunkSize; q++) {
+				const ui32 b = q * 4;
+				const ui32 quad[6] = { b, b + 1, b + 2, b + 2, b + 3, b };
+				std::copy(quad, quad + 6, elements.begin() + q * 6);
+			}
+
+			// filled through the array target, element bindings belong to the vertex arrays of the chunks
+			glGenBuffers(1, &ebo);
+			glBindBuffer(GL_ARRAY_BUFFER, ebo);
+			glBufferData(GL_ARRAY_BUFFER, elements.size() * sizeof(ui32), elements.data(), GL_STATIC_DRAW);
+		}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			for (Chunk& chunk : chunks) {
+				if (chunk.vbo != 0) glDeleteBuffers(1, &chunk.vbo);
+				if (chunk.vao != 0) glDeleteVertexArrays(1, &chunk.vao);
+				chunk = {};
+			}
+			if (ebo != 0) glDeleteBuffers(1, &ebo);
+			ebo = 0;
+		}
+
+		ui32 getWidth() const { return width; }
+		ui32 getHeight() const { return height; }
+		float getTileSize() const { return tileSize; }
+		ui32 getDrawnChunks() const { return drawnChunks; }
+
+		/*world position of the top left corner of tile (0, 0), rows go towards +y*/
+		void setOrigin(Vec2f _origin) {
+			origin = _origin;
+			for (Chunk& chunk : chunks) chunk.dirty = true;
+		}
+		Vec2f getOrigin() const { return origin; }
+
+		void setZ(float _z) { z = _z; }
+
+		ui32 getTile(ui32 x, ui32 y) const {
+			if (x >= width || y >= height) {
+				throw "Outside of range Exception";
+			}
+			return tiles[(size_t)y * width + x];
+		}
+
+		void setTile(ui32 x, ui32 y, ui32 tile) {
+			if (x >= width || y >= height) {
+				throw "Outside of range Exception";
+			}
+
+			ui32& current = tiles[(size_t)y * width + x];
+			if (current == tile) return;
+
+			current = tile;
+			chunks[(y / chunkSize) * chunkCols + x / chunkSize].dirty = true;
+		}
+
+		/*row by row, width * height ids*/
+		void setTiles(const std::vector<ui32>& newTiles) {
+			if (newTiles.size() != tiles.size()) {
+				throw "Outside of range Exception";
+			}
+			tiles = newTiles;
+			for (Chunk& chunk : chunks) chunk.dirty = true;
+		}
+
+		/*draws the chunks overlapping view, building the ones that changed*/
+		void draw(const AABB2f& view) {
+			prepare(view, frame);
+			draw(frame);
+		}
+
+		/*finds the chunks overlapping view and builds the vertices of the ones that changed, no gl call*/
+		void prepare(const AABB2f& view, Data& data) {
+			data.buildCount = 0;
+			data.visible.clear();
+			data.z = z;
+			drawnChunks = 0;
+
+			if (view.max.x < origin.x || view.max.y < origin.y ||
+				view.min.x > origin.x + width * tileSize || view.min.y > origin.y + height * tileSize) return;
+
+			const float chunkWorld = chunkSize * tileSize;
+			const i32 cx0 = clampIndex(floorf((view.min.x - origin.x) / chunkWorld), chunkCols);
+			const i32 cy0 = clampIndex(floorf((view.min.y - origin.y) / chunkWorld), chunkRows);
+			const i32 cx1 = clampIndex(floorf((view.max.x - origin.x) / chunkWorld), chunkCols);
+			const i32 cy1 = clampIndex(floorf((view.max.y - origin.y) / chunkWorld), chunkRows);
+
+			for (i32 cy = cy0; cy <= cy1; cy++) {
+				for (i32 cx = cx0; cx <= cx1; cx++) {
+					const ui32 index = cy * chunkCols + cx;
+					Chunk& chunk = chunks[index];
+
+					if (chunk.dirty) {
+						if (data.buildCount == data.builds.size()) data.builds.emplace_back();
+						Data::Build& b = data.builds[data.buildCount++];
+						b.chunk = index;
+						build(chunk, cx, cy, b.vertices);
+					}
+					if (chunk.quadCount == 0) continue;
+
+					data.visible.emplace_back(index, chunk.quadCount);
+					drawnChunks++;
+				}
+			}
+		}
+
+		/*sends the rebuilt chunks and draws the visible ones*/
+		void draw(const Data& data) {
+			for (size_t i = 0; i < data.buildCount; i++) upload(chunks[data.builds[i].chunk], data.builds[i].vertices);
+			if (data.visible.empty()) return;
+
+			program.use();
+			program.setFloat("z", data.z);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			DrawCounters().textureBinds++;
+
+			for (const auto& chunk : data.visible) {
+				glBindVertexArray(chunks[chunk.first].vao);
+				glDrawElements(GL_TRIANGLES, chunk.second * 6, GL_UNSIGNED_INT, 0);
+				DrawCounters().countDraw(chunk.second * 4, chunk.second * 6);
+			}
+		}
+
+	private:
+		static i32 clampIndex(float v, ui32 count) {
+			if (!(v > 0.f)) return 0;
+			return v >= (float)count ? (i32)count - 1 : (i32)v;
+		}
+
+		void build(Chunk& chunk, ui32 cx, ui32 cy, std::vector<float>& scratch) {
+			scratch.clear();
+
+			const float du = 1.f / tilesetCols, dv = 1.f / tilesetRows;
+			const ui32 tileCount = tilesetCols * tilesetRows;
+
+			const ui32 x0 = cx * chunkSize, y0 = cy * chunkSize;
+			const ui32 x1 = x0 + chunkSize < width ? x0 + chunkSize : width;
+			const ui32 y1 = y0 + chunkSize < height ? y0 + chunkSize : height;
+
+			for (ui32 y = y0; y < y1; y++) {
+				for (ui32 x = x0; x < x1; x++) {
+					const ui32 tile = tiles[(size_t)y * width + x];
+					if (tile >= tileCount) continue;
+
+					const float px = origin.x + x * tileSize, py = origin.y + y * tileSize;
+					const float u0 = (tile % tilesetCols) * du + uvInset.x, v0 = (tile / tilesetCols) * dv + uvInset.y;
+					const float u1 = u0 + du - 2.f * uvInset.x, v1 = v0 + dv - 2.f * uvInset.y;
+
+					scratch.insert(scratch.end(), {
+						px, py, u0, v0,
+						px + tileSize, py, u1, v0,
+						px + tileSize, py + tileSize, u1, v1,
+						px, py + tileSize, u0, v1
+					});
+				}
+			}
+
+			chunk.quadCount = (ui32)(scratch.size() / (VERTEX_FLOATS * 4));
+			chunk.dirty = false;
+		}
+
+		void upload(Chunk& chunk, const std::vector<float>& vertices) {
+			if (vertices.empty()) return;
+
+			if (chunk.vao == 0) {
+				glGenVertexArrays(1, &chunk.vao);
+				glGenBuffers(1, &chunk.vbo);
+
+				glBindVertexArray(chunk.vao);
+				glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+				const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+				glEnableVertexAttribArray(0);
+				glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+				glEnableVertexAttribArray(1);
+				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+			}
+			else {
+				glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+			}
+
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+			DrawCounters().vertexBytes += vertices.size() * sizeof(float);
+		}
+	};
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "FrameStats.h"
+
+namespace voi {
+	/*2x3 affine matrix: x' = a * x + b * y + tx, y' = c * x + d * y + ty*/
+	struct Affine2D {
+		float a = 1.f, b = 0.f, tx = 0.f;
+		float c = 0.f, d = 1.f, ty = 0.f;
+
+		static Affine2D Translation(Vec2f t) {
+			return { 1.f, 0.f, t.x, 0.f, 1.f, t.y };
+		}
+
+		/*scale, then rotate, then translate*/
+		static Affine2D Make(Vec2f pos, float rotation = 0.f, Vec2f scale = { 1.f, 1.f }) {
+			const float cs = cosf(rotation), sn = sinf(rotation);
+			return {
+				cs * scale.x, -sn * scale.y, pos.x,
+				sn * scale.x,  cs * scale.y, pos.y
+			};
+		}
+
+		Vec2f apply(Vec2f p) const { return { a * p.x + b * p.y + tx, c * p.x + d * p.y + ty }; }
+	};
+
+	/*array of affine transforms living in a texture buffer object, vertices reference them by index
+	so moving an object only rewrites its entry. every transform takes two RGBA32F texels on the gpu*/
+	class TransformPalette {
+	public:
+		/*transforms changed since the previous capture, packed for the buffer, so they can be sent from the
+		thread that draws*/
+		struct Data {
+			std::vector<float> staging;
+			size_t begin = 0;
+			// the buffer is reallocated to this many transforms first when it holds less
+			size_t capacity = 0;
+		};
+
+	private:
+		std::vector<Affine2D> transforms;
+		Data staged;
+
+		ui32 buffer = 0;
+		ui32 texture = 0;
+		// transforms the buffer holds, only touched by the thread that draws
+		size_t capacity = 0;
+		// what the buffer will hold once the captured data is sent
+		size_t reserved = 0;
+
+		size_t dirtyBegin = 0;
+		size_t dirtyEnd = 0;
+
+		static const ui32 FLOATS_PER_TRANSFORM = 8;
+
+	public:
+		TransformPalette() {}
+
+		/*has to run while the context is still alive*/
+		void release() {
+			if (texture != 0) glDeleteTextures(1, &texture);
+			if (buffer != 0) glDeleteBuffers(1, &buffer);
+			texture = buffer = 0;
+		}
+
+		void init(size_t initialCapacity = 256) {
+			glGenBuffers(1, &buffer);
+			glGenTextures(1, &texture);
+
+			reserved = initialCapacity;
+			reallocate(initialCapacity);
+		}
+
+		ui32 getTexture() const { return texture; }
+		size_t size() const { return transforms.size(); }
+
+		ui32 add(const Affine2D& transform = {}) {
+			transforms.push_back(transform);
+			markDirty(transforms.size() - 1);
+			return (ui32)(transforms.size() - 1);
+		}
+
+		void set(ui32 id, const Affine2D& transform) {
+			if (id < transforms.size()) {
+				transforms[id] = transform;
+				markDirty(id);
+			}
+			else {
+				throw "Outside of range Exception";
+			}
+		}
+
+		const Affine2D& get(ui32 id) const {
+			if (id < transforms.size()) {
+				return transforms[id];
+			}
+			throw "Outside of range Exception";
+		}
+
+		void clear() {
+			transforms.clear();
+			dirtyBegin = dirtyEnd = 0;
+		}
+
+		/*sends only the range of transforms modified since the last upload*/
+		void upload() {
+			capture(staged);
+			upload(staged);
+		}
+
+		/*packs the range modified since the previous capture into data*/
+		void capture(Data& data) {
+			data.staging.clear();
+			data.capacity = reserved;
+			if (dirtyBegin >= dirtyEnd) return;
+
+			// a new buffer starts empty, everything goes again
+			if (transforms.size() > reserved) {
+				size_t newCapacity = reserved > 0 ? reserved * 2 : 256;
+				while (newCapacity < transforms.size()) newCapacity *= 2;
+
+				reserved = data.capacity = newCapacity;
+				dirtyBegin = 0;
+				dirtyEnd = transforms.size();
+			}
+
+			const size_t count = dirtyEnd - dirtyBegin;
+			data.staging.resize(count * FLOATS_PER_TRANSFORM);
+			data.begin = dirtyBegin;
+
+			float* out = data.staging.data();
+			for (size_t i = dirtyBegin; i < dirtyEnd; i++) {
+				const Affine2D& t = transforms[i];
+				out[0] = t.a; out[1] = t.b; out[2] = t.tx; out[3] = 0.f;
+				out[4] = t.c; out[5] = t.d; out[6] = t.ty; out[7] = 0.f;
+				out += FLOATS_PER_TRANSFORM;
+			}
+
+			dirtyBegin = dirtyEnd = 0;
+		}
+
+		void upload(const Data& data) {
+			if (data.capacity > capacity) reallocate(data.capacity);
+			if (data.staging.empty()) return;
+
+			glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+			glBufferSubData(GL_TEXTURE_BUFFER, data.begin * FLOATS_PER_TRANSFORM * sizeof(float), data.staging.size() * sizeof(float), data.staging.data());
+			DrawCounters().otherBytes += data.staging.size() * sizeof(float);
+		}
+
+	private:
+		void markDirty(size_t id) {
+			if (dirtyBegin >= dirtyEnd) {
+				dirtyBegin = id;
+				dirtyEnd = id + 1;
+			}
+			else {
+				dirtyBegin = id < dirtyBegin ? id : dirtyBegin;
+				dirtyEnd = id + 1 > dirtyEnd ? id + 1 : dirtyEnd;
+			}
+		}
+
+		void reallocate(size_t newCapacity) {
+			capacity = newCapacity;
+
+			glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+			glBufferData(GL_TEXTURE_BUFFER, capacity * FLOATS_PER_TRANSFORM * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+		}
+	};
+}
@@ -0,0 +1,650 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+
+namespace voi {
+	/*ear clipping of polygons with holes. vertices live in a circular linked list, for large polygons the list
+	is also sorted along a z-order curve so the search for points inside an ear only walks the nearby ones.
+	holes are bridged into the outline first, what can't be clipped is filtered, cured of local
+	self-intersections or split in two, in that order*/
+	class Triangulator {
+		struct Node {
+			ui32 i;
+			double x, y;
+			Node* prev = nullptr;
+			Node* next = nullptr;
+			i32 z = 0;
+			Node* prevZ = nullptr;
+			Node* nextZ = nullptr;
+			bool steiner = false;
+
+			Node(ui32 _i, double _x, double _y) : i(_i), x(_x), y(_y) {}
+		};
+
+		std::deque<Node> nodes;
+		std::vector<ui32>* triangles = nullptr;
+
+		double minX = 0, minY = 0, invSize = 0;
+		bool hashed = false;
+
+		// outlines above this vertex count are indexed along the z-order curve
+		static const ui32 HASH_THRESHOLD = 80;
+
+	public:
+		/*points holds the outline followed by every hole, holeStarts the index of the first point of each hole.
+		appends three indices per triangle to out*/
+		void triangulate(const Vec2f* points, size_t count, const ui32* holeStarts, size_t holeCount, std::vector<ui32>& out) {
+			nodes.clear();
+			triangles = &out;
+
+			const size_t outerLen = holeCount > 0 ? holeStarts[0] : count;
+			Node* outer = linkedList(points, 0, outerLen, true);
+			if (outer == nullptr || outer->next == outer->prev) return;
+
+			if (holeCount > 0) outer = eliminateHoles(points, count, holeStarts, holeCount, outer);
+
+			hashed = count > HASH_THRESHOLD;
+			if (hashed) {
+				double maxX = minX = points[0].x, maxY = minY = points[0].y;
+				for (size_t i = 1; i < outerLen; i++) {
+					minX = points[i].x < minX ? points[i].x : minX;
+					minY = points[i].y < minY ? points[i].y : minY;
+					maxX = points[i].x > maxX ? points[i].x : maxX;
+					maxY = points[i].y > maxY ? points[i].y : maxY;
+				}
+				invSize = std::max(maxX - minX, maxY - minY);
+				invSize = invSize != 0 ? 32767.0 / invSize : 0;
+				hashed = invSize != 0;
+			}
+
+			earcutLinked(outer, 0);
+		}
+
+	private:
+		Node* insertNode(ui32 i, double x, double y, Node* last) {
+			nodes.emplace_back(i, x, y);
+			Node* p = &nodes.back();
+
+			if (last == nullptr) {
+				p->prev = p;
+				p->next = p;
+			}
+			else {
+				p->next = last->next;
+				p->prev = last;
+				last->next->prev = p;
+				last->next = p;
+			}
+			return p;
+		}
+
+		static void removeNode(Node* p) {
+			p->next->prev = p->prev;
+			p->prev->next = p->next;
+
+			if (p->prevZ) p->prevZ->nextZ = p->nextZ;
+			if (p->nextZ) p->nextZ->prevZ = p->prevZ;
+		}
+
+		static double signedArea(const Vec2f* points, size_t start, size_t end) {
+			double sum = 0;
+			for (size_t i = start, j = end - 1; i < end; i++) {
+				sum += ((double)points[j].x - points[i].x) * ((double)points[i].y + points[j].y);
+				j = i;
+			}
+			return sum;
+		}
+
+		/*circular list of the points in the requested winding*/
+		Node* linkedList(const Vec2f* points, size_t start, size_t end, bool clockwise) {
+			Node* last = nullptr;
+			if (end <= start) return last;
+
+			if (clockwise == (signedArea(points, start, end) > 0)) {
+				for (size_t i = start; i < end; i++) last = insertNode((ui32)i, points[i].x, points[i].y, last);
+			}
+			else {
+				for (size_t i = end; i-- > start;) last = insertNode((ui32)i, points[i].x, points[i].y, last);
+			}
+
+			if (last && equals(last, last->next)) {
+				removeNode(last);
+				last = last->next;
+			}
+			return last;
+		}
+
+		/*drops duplicated and collinear points*/
+		static Node* filterPoints(Node* start, Node* end = nullptr) {
+			if (start == nullptr) return start;
+			if (end == nullptr) end = start;
+
+			Node* p = start;
+			bool again;
+			do {
+				again = false;
+
+				if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0)) {
+					removeNode(p);
+					p = end = p->prev;
+					if (p == p->next) break;
+					again = true;
+				}
+				else {
+					p = p->next;
+				}
+			} while (again || p != end);
+
+			return end;
+		}
+
+		void earcutLinked(Node* ear, int pass) {
+			if (ear == nullptr) return;
+
+			if (pass == 0 && hashed) indexCurve(ear);
+
+			Node* stop = ear;
+			while (ear->prev != ear->next) {
+				Node* prev = ear->prev;
+				Node* next = ear->next;
+
+				if (hashed ? isEarHashed(ear) : isEar(ear)) {
+					triangles->insert(triangles->end(), { prev->i, ear->i, next->i });
+					removeNode(ear);
+
+					// skipping the next vertex leaves less slivers
+					ear = next->next;
+					stop = next->next;
+					continue;
+				}
+
+				ear = next;
+
+				if (ear == stop) {
+					if (pass == 0) {
+						earcutLinked(filterPoints(ear), 1);
+					}
+					else if (pass == 1) {
+						ear = cureLocalIntersections(filterPoints(ear));
+						earcutLinked(ear, 2);
+					}
+					else if (pass == 2) {
+						splitEarcut(ear);
+					}
+					break;
+				}
+			}
+		}
+
+		static bool isEar(Node* ear) {
+			const Node* a = ear->prev;
+			const Node* b = ear;
+			const Node* c = ear->next;
+
+			if (area(a, b, c) >= 0) return false;
+
+			const double x0 = std::min(a->x, std::min(b->x, c->x)), y0 = std::min(a->y, std::min(b->y, c->y));
+			const double x1 = std::max(a->x, std::max(b->x, c->x)), y1 = std::max(a->y, std::max(b->y, c->y));
+
+			const Node* p = c->next;
+			while (p != a) {
+				if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+					pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+					area(p->prev, p, p->next) >= 0) return false;
+				p = p->next;
+			}
+			return true;
+		}
+
+		bool isEarHashed(Node* ear) const {
+			const Node* a = ear->prev;
+			const Node* b = ear;
+			const Node* c = ear->next;
+
+			if (area(a, b, c) >= 0) return false;
+
+			const double x0 = std::min(a->x, std::min(b->x, c->x)), y0 = std::min(a->y, std::min(b->y, c->y));
+			const double x1 = std::max(a->x, std::max(b->x, c->x)), y1 = std::max(a->y, std::max(b->y, c->y));
+
+			const i32 minZ = zOrder(x0, y0), maxZ = zOrder(x1, y1);
+
+			auto blocks = [&](const Node* p) {
+				return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && p != a && p != c &&
+					pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+					area(p->prev, p, p->next) >= 0;
+			};
+
+			// walks the z-order list both ways from the ear until leaving the range of its bounding box
+			const Node* p = ear->prevZ;
+			const Node* n = ear->nextZ;
+
+			while (p && p->z >= minZ && n && n->z <= maxZ) {
+				if (blocks(p)) return false;
+				p = p->prevZ;
+				if (blocks(n)) return false;
+				n = n->nextZ;
+			}
+			while (p && p->z >= minZ) {
+				if (blocks(p)) return false;
+				p = p->prevZ;
+			}
+			while (n && n->z <= maxZ) {
+				if (blocks(n)) return false;
+				n = n->nextZ;
+			}
+			return true;
+		}
+
+		Node* cureLocalIntersections(Node* start) {
+			Node* p = start;
+			do {
+				Node* a = p->prev;
+				Node* b = p->next->next;
+
+				if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+					triangles->insert(triangles->end(), { a->i, p->i, b->i });
+
+					removeNode(p);
+					removeNode(p->next);
+					p = start = b;
+				}
+				p = p->next;
+			} while (p != start);
+
+			return filterPoints(p);
+		}
+
+		void splitEarcut(Node* start) {
+			Node* a = start;
+			do {
+				Node* b = a->next->next;
+				while (b != a->prev) {
+					if (a->i != b->i && isValidDiagonal(a, b)) {
+						Node* c = splitPolygon(a, b);
+
+						a = filterPoints(a, a->next);
+						c = filterPoints(c, c->next);
+
+						earcutLinked(a, 0);
+						earcutLinked(c, 0);
+						return;
+					}
+					b = b->next;
+				}
+				a = a->next;
+			} while (a != start);
+		}
+
+		Node* eliminateHoles(const Vec2f* points, size_t count, const ui32* holeStarts, size_t holeCount, Node* outer) {
+			std::vector<Node*> queue;
+			queue.reserve(holeCount);
+
+			for (size_t i = 0; i < holeCount; i++) {
+				const size_t start = holeStarts[i];
+				const size_t end = i + 1 < holeCount ? holeStarts[i + 1] : count;
+
+				Node* list = linkedList(points, start, end, false);
+				if (list == nullptr) continue;
+				if (list == list->next) list->steiner = true;
+
+				queue.push_back(getLeftmost(list));
+			}
+
+			std::sort(queue.begin(), queue.end(), [](const Node* a, const Node* b) { return a->x < b->x; });
+
+			// left to right, so every bridge can see the outline through the holes already merged
+			for (Node* hole : queue) {
+				outer = eliminateHole(hole, outer);
+			}
+			return outer;
+		}
+
+		Node* eliminateHole(Node* hole, Node* outer) {
+			Node* bridge = findHoleBridge(hole, outer);
+			if (bridge == nullptr) return outer;
+
+			Node* bridgeReverse = splitPolygon(bridge, hole);
+
+			filterPoints(bridgeReverse, bridgeReverse->next);
+			return filterPoints(bridge, bridge->next);
+		}
+
+		/*David Eberly's hole bridging: cast a ray to the left of the leftmost hole point and connect it to the
+		closest visible vertex*/
+		static Node* findHoleBridge(Node* hole, Node* outer) {
+			Node* p = outer;
+			const double hx = hole->x, hy = hole->y;
+			double qx = -INFINITY;
+			Node* m = nullptr;
+
+			do {
+				if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+					const double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+					if (x <= hx && x > qx) {
+						qx = x;
+						m = p->x < p->next->x ? p : p->next;
+						if (x == hx) return m;
+					}
+				}
+				p = p->next;
+			} while (p != outer);
+
+			if (m == nullptr) return nullptr;
+
+			const Node* stop = m;
+			const double mx = m->x, my = m->y;
+			double tanMin = INFINITY;
+
+			p = m;
+			do {
+				if (hx >= p->x && p->x >= mx && hx != p->x &&
+					pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+
+					const double tan = fabs(hy - p->y) / (hx - p->x);
+
+					if (locallyInside(p, hole) &&
+						(tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p)))))) {
+						m = p;
+						tanMin = tan;
+					}
+				}
+				p = p->next;
+			} while (p != stop);
+
+			return m;
+		}
+
+		static bool sectorContainsSector(const Node* m, const Node* p) {
+			return area(m->prev, m, p->prev) < 0 && area(p->next, m, m->next) < 0;
+		}
+
+		void indexCurve(Node* start) {
+			Node* p = start;
+			do {
+				if (p->z == 0) p->z = zOrder(p->x, p->y);
+				p->prevZ = p->prev;
+				p->nextZ = p->next;
+				p = p->next;
+			} while (p != start);
+
+			p->prevZ->nextZ = nullptr;
+			p->prevZ = nullptr;
+
+			sortLinked(p);
+		}
+
+		/*Simon Tatham's linked list merge sort*/
+		static Node* sortLinked(Node* list) {
+			ui32 inSize = 1;
+			ui32 numMerges;
+
+			do {
+				Node* p = list;
+				Node* tail = nullptr;
+				list = nullptr;
+				numMerges = 0;
+
+				while (p) {
+					numMerges++;
+					Node* q = p;
+					ui32 pSize = 0;
+					for (ui32 i = 0; i < inSize; i++) {
+						pSize++;
+						q = q->nextZ;
+						if (!q) break;
+					}
+					ui32 qSize = inSize;
+
+					while (pSize > 0 || (qSize > 0 && q)) {
+						Node* e;
+						if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z)) {
+							e = p;
+							p = p->nextZ;
+							pSize--;
+						}
+						else {
+							e = q;
+							q = q->nextZ;
+							qSize--;
+						}
+
+						if (tail) tail->nextZ = e;
+						else list = e;
+
+						e->prevZ = tail;
+						tail = e;
+					}
+					p = q;
+				}
+
+				tail->nextZ = nullptr;
+				inSize *= 2;
+			} while (numMerges > 1);
+
+			return list;
+		}
+
+		/*interleaved bits of the coordinates mapped into 15 bit integers*/
+		i32 zOrder(double px, double py) const {
+			i32 x = (i32)((px - minX) * invSize);
+			i32 y = (i32)((py - minY) * invSize);
+
+			x = (x | (x << 8)) & 0x00FF00FF;
+			x = (x | (x << 4)) & 0x0F0F0F0F;
+			x = (x | (x << 2)) & 0x33333333;
+			x = (x | (x << 1)) & 0x55555555;
+
+			y = (y | (y << 8)) & 0x00FF00FF;
+			y = (y | (y << 4)) & 0x0F0F0F0F;
+			y = (y | (y << 2)) & 0x33333333;
+			y = (y | (y << 1)) & 0x55555555;
+
+			return x | (y << 1);
+		}
+
+		static Node* getLeftmost(Node* start) {
+			Node* p = start;
+			Node* leftmost = start;
+			do {
+				if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) leftmost = p;
+				p = p->next;
+			} while (p != start);
+			return leftmost;
+		}
+
+		static bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+			return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+				(ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+				(bx - px) * (cy - py) >= (cx - px) * (by - py);
+		}
+
+		/*the diagonal lies inside of the polygon and doesn't cross any edge*/
+		static bool isValidDiagonal(Node* a, Node* b) {
+			return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b) &&
+				((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+					(area(a->prev, a, b->prev) != 0 || area(a, b->prev, b) != 0)) ||
+				(equals(a, b) && area(a->prev, a, a->next) > 0 && area(b->prev, b, b->next) > 0));
+		}
+
+		static double area(const Node* p, const Node* q, const Node* r) {
+			return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+		}
+
+		static bool equals(const Node* a, const Node* b) {
+			return a->x == b->x && a->y == b->y;
+		}
+
+		static int sign(double v) { return (v > 0) - (v < 0); }
+
+		static bool intersects(const Node* p1, const Node* q1, const Node* p2, const Node* q2) {
+			const int o1 = sign(area(p1, q1, p2));
+			const int o2 = sign(area(p1, q1, q2));
+			const int o3 = sign(area(p2, q2, p1));
+			const int o4 = sign(area(p2, q2, q1));
+
+			if (o1 != o2 && o3 != o4) return true;
+
+			if (o1 == 0 && onSegment(p1, p2, q1)) return true;
+			if (o2 == 0 && onSegment(p1, q2, q1)) return true;
+			if (o3 == 0 && onSegment(p2, p1, q2)) return true;
+			if (o4 == 0 && onSegment(p2, q1, q2)) return true;
+
+			return false;
+		}
+
+		/*for collinear p, q and r, whether q lies on the segment pr*/
+		static bool onSegment(const Node* p, const Node* q, const Node* r) {
+			return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+				q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+		}
+
+		static bool intersectsPolygon(const Node* a, const Node* b) {
+			const Node* p = a;
+			do {
+				if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+					intersects(p, p->next, a, b)) return true;
+				p = p->next;
+			} while (p != a);
+			return false;
+		}
+
+		static bool locallyInside(const Node* a, const Node* b) {
+			return area(a->prev, a, a->next) < 0 ?
+				area(a, b, a->next) >= 0 && area(a, a->prev, b) >= 0 :
+				area(a, b, a->prev) < 0 || area(a, a->next, b) < 0;
+		}
+
+		static bool middleInside(const Node* a, const Node* b) {
+			const Node* p = a;
+			bool inside = false;
+			const double px = (a->x + b->x) / 2, py = (a->y + b->y) / 2;
+
+			do {
+				if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+					(px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+					inside = !inside;
+				}
+				p = p->next;
+			} while (p != a);
+
+			return inside;
+		}
+
+		/*links a and b with a bridge: splits the ring in two when both are in the same one, merges the rings
+		otherwise. returns the copy of b*/
+		Node* splitPolygon(Node* a, Node* b) {
+			nodes.emplace_back(a->i, a->x, a->y);
+			Node* a2 = &nodes.back();
+			nodes.emplace_back(b->i, b->x, b->y);
+			Node* b2 = &nodes.back();
+
+			Node* an = a->next;
+			Node* bp = b->prev;
+
+			a->next = b;
+			b->prev = a;
+
+			a2->next = an;
+			an->prev = a2;
+
+			b2->next = a2;
+			a2->prev = b2;
+
+			bp->next = b2;
+			b2->prev = bp;
+
+			return b2;
+		}
+	};
+
+	/*triangulations kept by the content of the polygon, entries not used for maxAge frames are dropped*/
+	class TriangulationCache {
+		struct Entry {
+			std::vector<Vec2f> points;
+			std::vector<ui32> holeStarts;
+			std::vector<ui32> indices;
+			ui64 lastUsed = 0;
+		};
+
+		std::unordered_map<ui64, Entry> entries;
+		Triangulator triangulator;
+
+		ui64 frame = 0;
+		ui64 maxAge;
+
+	public:
+		TriangulationCache(ui64 _maxAge = 120) : maxAge(_maxAge) {}
+
+		size_t size() const { return entries.size(); }
+
+		static ui64 Hash(const Vec2f* points, size_t count, const ui32* holeStarts, size_t holeCount) {
+			// FNV-1a style, eight bytes at a time
+			ui64 h = 14695981039346656037ull;
+			auto mix = [&h](const void* data, size_t size) {
+				const ui8* bytes = (const ui8*)data;
+				size_t i = 0;
+				for (; i + 8 <= size; i += 8) {
+					ui64 word;
+					std::memcpy(&word, bytes + i, 8);
+					h = (h ^ word) * 1099511628211ull;
+					h ^= h >> 29;
+				}
+				for (; i < size; i++) {
+					h = (h ^ bytes[i]) * 1099511628211ull;
+				}
+			};
+
+			mix(points, count * sizeof(Vec2f));
+			mix(holeStarts, holeCount * sizeof(ui32));
+			mix(&count, sizeof(count));
+
+			return h;
+		}
+
+		/*triangle indices of the polygon, computed only the first time this exact polygon is seen*/
+		const std::vector<ui32>& get(const Vec2f* points, size_t count, const ui32* holeStarts = nullptr, size_t holeCount = 0) {
+			ui64 h = Hash(points, count, holeStarts, holeCount);
+
+			// different polygons with the same hash probe the following keys
+			while (true) {
+				auto it = entries.find(h);
+				if (it == entries.end()) break;
+
+				Entry& e = it->second;
+				if (e.points.size() == count && e.holeStarts.size() == holeCount &&
+					std::memcmp(e.points.data(), points, count * sizeof(Vec2f)) == 0 &&
+					(holeCount == 0 || std::memcmp(e.holeStarts.data(), holeStarts, holeCount * sizeof(ui32)) == 0)) {
+
+					e.lastUsed = frame;
+					return e.indices;
+				}
+				h++;
+			}
+
+			Entry& e = entries[h];
+			e.points.assign(points, points + count);
+			e.holeStarts.assign(holeStarts, holeStarts + holeCount);
+			e.lastUsed = frame;
+			triangulator.triangulate(points, count, holeStarts, holeCount, e.indices);
+
+			return e.indices;
+		}
+
+		void endFrame() {
+			frame++;
+
+			for (auto it = entries.begin(); it != entries.end();) {
+				if (frame - it->second.lastUsed > maxAge) it = entries.erase(it);
+				else ++it;
+			}
+		}
+	};
+}
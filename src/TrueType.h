@@ -0,0 +1,470 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+#include "utilDefs.h"
+#include "Lineal.h"
+#include "Path.h"
+
+namespace voi {
+	/*read only view of a TrueType font: character map, metrics, kerning pairs and quadratic outlines of
+	the glyf table. hinting, GPOS and CFF outlines are not supported*/
+	class TrueType {
+		std::vector<ui8> data;
+
+		ui32 glyf = 0, loca = 0, hmtx = 0, kern = 0;
+		ui32 cmapTable = 0;
+		ui16 cmapFormat = 0;
+
+		ui16 numGlyphs = 0;
+		ui16 numHMetrics = 0;
+		i16 locaFormat = 0;
+
+	public:
+		ui16 unitsPerEm = 0;
+		i16 ascender = 0;
+		i16 descender = 0;
+		i16 lineGap = 0;
+
+		bool load(const std::string& path) {
+			std::ifstream file(path, std::ios::binary);
+			if (!file) {
+				std::cout << "ERROR::FONT::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+				return false;
+			}
+			data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+			if (!parse()) {
+				std::cout << "ERROR::FONT::UNSUPPORTED_FORMAT " << path << std::endl;
+				data.clear();
+				return false;
+			}
+			return true;
+		}
+
+		bool isLoaded() const { return !data.empty(); }
+
+		ui32 glyphIndex(ui32 codepoint) const {
+			if (cmapFormat == 4) {
+				if (codepoint > 0xffff) return 0;
+
+				const ui32 segCount = u16(cmapTable + 6) / 2;
+				const ui32 ends = cmapTable + 14;
+				const ui32 starts = ends + segCount * 2 + 2;
+				const ui32 deltas = starts + segCount * 2;
+				const ui32 ranges = deltas + segCount * 2;
+
+				// first segment whose end is not below the codepoint
+				ui32 lo = 0, hi = segCount;
+				while (lo < hi) {
+					const ui32 mid = (lo + hi) / 2;
+					if (u16(ends + mid * 2) < codepoint) lo = mid + 1;
+					else hi = mid;
+				}
+				if (lo == segCount) return 0;
+
+				const ui32 start = u16(starts + lo * 2);
+				if (codepoint < start) return 0;
+
+				const ui16 delta = u16(deltas + lo * 2);
+				const ui16 rangeOffset = u16(ranges + lo * 2);
+				if (rangeOffset == 0) return (codepoint + delta) & 0xffff;
+
+				const ui32 glyph = u16(ranges + lo * 2 + rangeOffset + (codepoint - start) * 2);
+				return glyph == 0 ? 0 : (glyph + delta) & 0xffff;
+			}
+			if (cmapFormat == 12) {
+				const ui32 groups = u32(cmapTable + 12);
+
+				ui32 lo = 0, hi = groups;
+				while (lo < hi) {
+					const ui32 mid = (lo + hi) / 2;
+					const ui32 group = cmapTable + 16 + mid * 12;
+
+					if (codepoint < u32(group)) hi = mid;
+					else if (codepoint > u32(group + 4)) lo = mid + 1;
+					else return u32(group + 8) + codepoint - u32(group);
+				}
+			}
+			return 0;
+		}
+
+		i32 advance(ui32 glyph) const {
+			if (numHMetrics == 0) return 0;
+			return u16(hmtx + 4 * (glyph < numHMetrics ? glyph : numHMetrics - 1));
+		}
+
+		/*horizontal kerning between two glyphs from the kern table, in font units*/
+		i32 kerning(ui32 left, ui32 right) const {
+			if (kern == 0) return 0;
+
+			const ui32 pairs = u16(kern + 10);
+			const ui32 key = (left << 16) | right;
+
+			ui32 lo = 0, hi = pairs;
+			while (lo < hi) {
+				const ui32 mid = (lo + hi) / 2;
+				const ui32 pair = kern + 18 + mid * 6;
+				const ui32 k = u32(pair);
+
+				if (key < k) hi = mid;
+				else if (key > k) lo = mid + 1;
+				else return i16s(pair + 4);
+			}
+			return 0;
+		}
+
+		/*bounding box of the glyph in font units, false for glyphs without outline*/
+		bool bounds(ui32 glyph, i32& xMin, i32& yMin, i32& xMax, i32& yMax) const {
+			const ui32 g = glyphOffset(glyph);
+			if (g == 0) return false;
+
+			xMin = i16s(g + 2); yMin = i16s(g + 4);
+			xMax = i16s(g + 6); yMax = i16s(g + 8);
+			return true;
+		}
+
+		/*adds the contours of the glyph to out as x * m + t, m is the 2x2 matrix { m00, m01, m10, m11 }*/
+		void outline(ui32 glyph, Path& out, const float m[4], Vec2f t) const {
+			outline(glyph, out, m, t, 0);
+		}
+
+	private:
+		ui16 u16(ui32 off) const {
+			if (off + 2 > data.size()) return 0;
+			return (ui16)((data[off] << 8) | data[off + 1]);
+		}
+		i16 i16s(ui32 off) const { return (i16)u16(off); }
+		ui32 u32(ui32 off) const {
+			if (off + 4 > data.size()) return 0;
+			return ((ui32)data[off] << 24) | ((ui32)data[off + 1] << 16) | ((ui32)data[off + 2] << 8) | data[off + 3];
+		}
+
+		ui32 findTable(ui32 font, const char* tag) const {
+			const ui32 tables = u16(font + 4);
+			for (ui32 i = 0; i < tables; i++) {
+				const ui32 record = font + 12 + i * 16;
+				if (record + 16 > data.size()) break;
+
+				if (data[record] == (ui8)tag[0] && data[record + 1] == (ui8)tag[1] &&
+					data[record + 2] == (ui8)tag[2] && data[record + 3] == (ui8)tag[3]) {
+					return u32(record + 8);
+				}
+			}
+			return 0;
+		}
+
+		bool parse() {
+			if (data.size() < 12) return false;
+
+			// collections use their first font
+			ui32 font = 0;
+			if (data[0] == 't' && data[1] == 't' && data[2] == 'c' && data[3] == 'f') font = u32(12);
+
+			const ui32 head = findTable(font, "head");
+			const ui32 hhea = findTable(font, "hhea");
+			const ui32 maxp = findTable(font, "maxp");
+			const ui32 cmap = findTable(font, "cmap");
+			glyf = findTable(font, "glyf");
+			loca = findTable(font, "loca");
+			hmtx = findTable(font, "hmtx");
+
+			if (!head || !hhea || !maxp || !cmap || !glyf || !loca || !hmtx) return false;
+
+			unitsPerEm = u16(head + 18);
+			locaFormat = i16s(head + 50);
+			numGlyphs = u16(maxp + 4);
+
+			ascender = i16s(hhea + 4);
+			descender = i16s(hhea + 6);
+			lineGap = i16s(hhea + 8);
+			numHMetrics = u16(hhea + 34);
+
+			// only the first subtable of a version 0 kern table, when it holds horizontal format 0 pairs
+			const ui32 kernTable = findTable(font, "kern");
+			if (kernTable && u16(kernTable) == 0 && u16(kernTable + 2) > 0 && (u16(kernTable + 8) & 0xff03) == 0x0001) {
+				kern = kernTable;
+			}
+
+			// unicode subtables, full repertoire first
+			const ui32 subtables = u16(cmap + 2);
+			ui32 bmp = 0, full = 0;
+			for (ui32 i = 0; i < subtables; i++) {
+				const ui32 record = cmap + 4 + i * 8;
+				const ui16 platform = u16(record), encoding = u16(record + 2);
+				const ui32 table = cmap + u32(record + 4);
+				const ui16 format = u16(table);
+
+				const bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+				if (!unicode) continue;
+
+				if (format == 12 && !full) full = table;
+				if (format == 4 && !bmp) bmp = table;
+			}
+
+			cmapTable = full ? full : bmp;
+			cmapFormat = full ? 12 : (bmp ? 4 : 0);
+
+			return cmapFormat != 0 && unitsPerEm != 0;
+		}
+
+		/*offset of the glyph data, 0 for empty glyphs*/
+		ui32 glyphOffset(ui32 glyph) const {
+			if (glyph >= numGlyphs) return 0;
+
+			ui32 begin, end;
+			if (locaFormat == 0) {
+				begin = u16(loca + glyph * 2) * 2;
+				end = u16(loca + glyph * 2 + 2) * 2;
+			}
+			else {
+				begin = u32(loca + glyph * 4);
+				end = u32(loca + glyph * 4 + 4);
+			}
+			return begin == end ? 0 : glyf + begin;
+		}
+
+		void outline(ui32 glyph, Path& out, const float m[4], Vec2f t, int depth) const {
+			const ui32 g = glyphOffset(glyph);
+			if (g == 0 || depth > 8) return;
+
+			const i16 contours = i16s(g);
+			if (contours >= 0) simpleOutline(g, contours, out, m, t);
+			else compositeOutline(g, out, m, t, depth);
+		}
+
+		void simpleOutline(ui32 g, ui32 contours, Path& out, const float m[4], Vec2f t) const {
+			enum { ON_CURVE = 1, X_SHORT = 2, Y_SHORT = 4, REPEAT = 8, X_SAME = 16, Y_SAME = 32 };
+
+			const ui32 ends = g + 10;
+			const ui32 pointCount = contours > 0 ? u16(ends + (contours - 1) * 2) + 1u : 0u;
+			if (pointCount == 0) return;
+
+			ui32 off = ends + contours * 2;
+			off += 2 + u16(off);
+
+			std::vector<ui8> flags(pointCount);
+			for (ui32 i = 0; i < pointCount && off < data.size();) {
+				const ui8 f = data[off++];
+				flags[i++] = f;
+
+				if (f & REPEAT) {
+					ui32 repeat = off < data.size() ? data[off++] : 0;
+					while (repeat-- > 0 && i < pointCount) flags[i++] = f;
+				}
+			}
+
+			std::vector<Vec2f> points(pointCount);
+			i32 x = 0, y = 0;
+			for (ui32 i = 0; i < pointCount; i++) {
+				if (flags[i] & X_SHORT) {
+					const i32 dx = off < data.size() ? data[off++] : 0;
+					x += (flags[i] & X_SAME) ? dx : -dx;
+				}
+				else if (!(flags[i] & X_SAME)) {
+					x += i16s(off);
+					off += 2;
+				}
+				points[i].x = (float)x;
+			}
+			for (ui32 i = 0; i < pointCount; i++) {
+				if (flags[i] & Y_SHORT) {
+					const i32 dy = off < data.size() ? data[off++] : 0;
+					y += (flags[i] & Y_SAME) ? dy : -dy;
+				}
+				else if (!(flags[i] & Y_SAME)) {
+					y += i16s(off);
+					off += 2;
+				}
+				points[i].y = (float)y;
+			}
+
+			auto transform = [&](const Vec2f& p) -> Vec2f {
+				return { m[0] * p.x + m[1] * p.y + t.x, m[2] * p.x + m[3] * p.y + t.y };
+			};
+			auto mid = [](const Vec2f& a, const Vec2f& b) -> Vec2f {
+				return { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f };
+			};
+
+			ui32 first = 0;
+			for (ui32 c = 0; c < contours; c++) {
+				const ui32 last = u16(ends + c * 2);
+				if (last < first || last >= pointCount) break;
+
+				const ui32 n = last - first + 1;
+				auto point = [&](ui32 i) -> const Vec2f& { return points[first + (i % n)]; };
+				auto on = [&](ui32 i) -> bool { return (flags[first + (i % n)] & ON_CURVE) != 0; };
+
+				// starts at an on curve point, or between two control points when there is none at the start
+				ui32 begin = 0, steps = n;
+				bool hasControl = false;
+				Vec2f start, control;
+
+				if (on(0)) start = point(0);
+				else if (on(n - 1)) { start = point(n - 1); begin = n - 1; }
+				else {
+					start = mid(point(n - 1), point(0));
+					control = point(0);
+					hasControl = true;
+					steps = n - 1;
+				}
+
+				out.moveTo(transform(start));
+
+				for (ui32 k = 1; k <= steps; k++) {
+					const ui32 i = begin + k;
+					const Vec2f& p = point(i);
+
+					if (on(i)) {
+						if (hasControl) out.quadTo(transform(control), transform(p));
+						else out.lineTo(transform(p));
+						hasControl = false;
+					}
+					else {
+						// two control points in a row have an implied on curve point halfway
+						if (hasControl) out.quadTo(transform(control), transform(mid(control, p)));
+						control = p;
+						hasControl = true;
+					}
+				}
+				if (hasControl) out.quadTo(transform(control), transform(start));
+
+				out.close();
+				first = last + 1;
+			}
+		}
+
+		void compositeOutline(ui32 g, Path& out, const float m[4], Vec2f t, int depth) const {
+			enum { WORDS = 1, XY_VALUES = 2, SCALE = 8, MORE = 32, XY_SCALE = 64, TWO_BY_TWO = 128 };
+
+			ui32 off = g + 10;
+			ui16 flags;
+			do {
+				flags = u16(off);
+				const ui16 component = u16(off + 2);
+				off += 4;
+
+				float dx, dy;
+				if (flags & WORDS) {
+					dx = i16s(off); dy = i16s(off + 2);
+					off += 4;
+				}
+				else {
+					dx = (float)(i8)data[off]; dy = (float)(i8)data[off + 1];
+					off += 2;
+				}
+				// point matching offsets are not supported
+				if (!(flags & XY_VALUES)) dx = dy = 0.f;
+
+				float a = 1.f, b = 0.f, c = 0.f, d = 1.f;
+				if (flags & SCALE) {
+					a = d = i16s(off) / 16384.f;
+					off += 2;
+				}
+				else if (flags & XY_SCALE) {
+					a = i16s(off) / 16384.f; d = i16s(off + 2) / 16384.f;
+					off += 4;
+				}
+				else if (flags & TWO_BY_TWO) {
+					a = i16s(off) / 16384.f; b = i16s(off + 2) / 16384.f;
+					c = i16s(off + 4) / 16384.f; d = i16s(off + 6) / 16384.f;
+					off += 8;
+				}
+
+				// component space: x' = a x + c y + dx, y' = b x + d y + dy, then through m and t
+				const float cm[4] = {
+					m[0] * a + m[1] * b, m[0] * c + m[1] * d,
+					m[2] * a + m[3] * b, m[2] * c + m[3] * d
+				};
+				const Vec2f ct = { m[0] * dx + m[1] * dy + t.x, m[2] * dx + m[3] * dy + t.y };
+
+				outline(component, out, cm, ct, depth + 1);
+			} while ((flags & MORE) && off < data.size());
+		}
+	};
+
+	/*coverage of the flattened contours over a w * h bitmap, accumulating the signed area every edge leaves
+	on the cells it crosses and summing it along the rows. out gets values in [0, 1], row by row*/
+	inline void RasterizeCoverage(const std::vector<Vec2f>& points, const std::vector<ui32>& contourStarts,
+		ui32 w, ui32 h, std::vector<float>& acc, std::vector<ui8>& out) {
+
+		acc.assign((size_t)w * h + 4, 0.f);
+
+		auto line = [&](Vec2f p0, Vec2f p1) {
+			if (fabsf(p0.y - p1.y) <= 1e-6f) return;
+
+			float dir = 1.f;
+			if (p0.y > p1.y) {
+				std::swap(p0, p1);
+				dir = -1.f;
+			}
+
+			const float dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+			float x = p0.x;
+			if (p0.y < 0.f) x -= p0.y * dxdy;
+
+			const i32 yEnd = (i32)fminf((float)h, ceilf(p1.y));
+			for (i32 y = p0.y > 0.f ? (i32)p0.y : 0; y < yEnd; y++) {
+				float* row = acc.data() + (size_t)y * w;
+
+				const float dy = fminf((float)(y + 1), p1.y) - fmaxf((float)y, p0.y);
+				const float xNext = x + dxdy * dy;
+				const float d = dy * dir;
+
+				const float x0 = fmaxf(0.f, fminf(x, xNext)), x1 = fminf((float)w - 1.f, fmaxf(x, xNext));
+				const float x0Floor = floorf(x0), x1Ceil = ceilf(x1);
+				const i32 x0i = (i32)x0Floor, x1i = (i32)x1Ceil;
+
+				if (x1i <= x0i + 1) {
+					// within one cell, split by the mean x of the crossing
+					const float xm = 0.5f * (x0 + x1) - x0Floor;
+					row[x0i] += d - d * xm;
+					row[x0i + 1] += d * xm;
+				}
+				else {
+					const float s = 1.f / (x1 - x0);
+					const float x0f = x0 - x0Floor;
+					const float a0 = 0.5f * s * (1.f - x0f) * (1.f - x0f);
+					const float x1f = x1 - x1Ceil + 1.f;
+					const float am = 0.5f * s * x1f * x1f;
+
+					row[x0i] += d * a0;
+					if (x1i == x0i + 2) {
+						row[x0i + 1] += d * (1.f - a0 - am);
+					}
+					else {
+						const float a1 = s * (1.5f - x0f);
+						row[x0i + 1] += d * (a1 - a0);
+						for (i32 xi = x0i + 2; xi < x1i - 1; xi++) row[xi] += d * s;
+
+						const float a2 = a1 + (float)(x1i - x0i - 3) * s;
+						row[x1i - 1] += d * (1.f - a2 - am);
+					}
+					row[x1i] += d * am;
+				}
+				x = xNext;
+			}
+		};
+
+		for (size_t c = 0; c < contourStarts.size(); c++) {
+			const size_t start = contourStarts[c];
+			const size_t end = c + 1 < contourStarts.size() ? contourStarts[c + 1] : points.size();
+
+			for (size_t i = start; i < end; i++) {
+				line(points[i], points[i + 1 < end ? i + 1 : start]);
+			}
+		}
+
+		out.resize((size_t)w * h);
+		float sum = 0.f;
+		for (size_t i = 0; i < out.size(); i++) {
+			sum += acc[i];
+			const float a = fminf(fabsf(sum), 1.f);
+			out[i] = (ui8)(a * 255.f + 0.5f);
+		}
+	}
+}